@@ -123,7 +123,7 @@ extern "C"
     ISR_MAP(    ePort_1     ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        )\
     ISR_MAP(    ePort_2     ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        )\
     ISR_MAP(    ePort_3     ,       NULL        ,DR_UI_InfraredInputIRQ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        )\
-    ISR_MAP(    ePort_4     ,       DR_Regulation_RxInterruptOnSleep        ,       NULL        ,       NULL        , DR_UI_CheckSensorForMotion  ,       NULL        ,       NULL        ,       NULL        ,       NULL        )\
+    ISR_MAP(    ePort_4     ,       DR_Regulation_RxInterruptOnSleep        ,       NULL        ,       NULL        , DR_UI_MotionSensorIRQ  ,       NULL        ,       NULL        ,       NULL        ,       NULL        )\
     ISR_MAP(    ePort_5     ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        )\
     ISR_MAP(    ePort_6     ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        )\
     ISR_MAP(    ePort_7     ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        ,       NULL        )
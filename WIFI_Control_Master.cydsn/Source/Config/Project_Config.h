@@ -30,7 +30,8 @@
 #define CURRENT_MAX_LIMIT        2000   //2000mA is the maximum limit
 #define VOLTAGE_STEP             10     //10mV voltage steps
 
-#define SAVE_IN_FLASH_TIMEOUT    30000  //Timeout until the new value is saved in the flash (in ms)
+#define SAVE_IN_FLASH_TIMEOUT    5000   //Time without changes until the new value is saved in the flash (in ms)
+#define SAVE_IN_FLASH_MAX_DEFER  30000  //Maximum time a change waits for the flash while the values keep changing (in ms)
 
 #define ENABLE_FAST_STANDBY     false
 #if ENABLE_FAST_STANDBY
@@ -45,11 +46,39 @@
     
 #define USER_TIMER_AMOUNT        4      //Amount of possible user timers
 
+#define SUN_DEFAULT_LATITUDE     5252   //Default location of the sun timer in 1/100 degree (Berlin)
+#define SUN_DEFAULT_LONGITUDE    1341
+
 /****   Defines for error detection module ****************************************************************************/
 #define PWM_TEST_RETRY 10
 #define MAX_MILLI_CURRENT_VALUE 2000    //Maximum current value in mA
 #define MAX_AMBIENT_TEMPERATURE 650     //65.0°C
 
+/****   Defines for the event queue *****************************************************************************************/
+#define EVT_QUEUE_HIGH_SIZE     8       //Depth of the high priority lane
+#define EVT_QUEUE_LOW_SIZE      16      //Depth of the low priority lane
+#define EVT_OS_STAMP_SIZE       8       //Post time stamps of the events which wait in the OS event manager
+#define EVT_BATCH_MAX_EVENTS    8       //Maximum events which are handled in one main task iteration
+#define EVT_BATCH_MAX_TIME_MS   2       //Maximum time in ms for one batch of events. Checked after each event
+#define EVT_STAT_EVENT_IDS      32      //Event IDs with an own histogram. Higher IDs share the last one
+#define EVT_STAT_BUCKETS        6       //Buckets of the waiting and execution time histograms
+#define FLIGHT_REC_ENTRIES      32      //Entries of the flight recorder in the no-init RAM
+#define PROFILER_ENABLE         true    //Execution time measurement of the USER_PROFILE_LIST functions
+#define FLASH_JOB_MAX_ROWS      2       //Maximum size of a non-blocking flash write job in rows
+#define FLASH_WRITE_RETRIES     3       //Retries of a failed flash write job
+#define JOURNAL_PAGES           2       //Pages of the user settings journal. A full page is compacted into the next one
+#define JOURNAL_ROWS_PER_PAGE   4       //Flash rows of one journal page
+#define JOURNAL_CHUNK_SIZE      8       //Bytes of the user settings in one journal record
+#define FAULT_LOG_ROWS          4       //Flash rows of the fault log ring. Each row holds 8 faults
+#define FAULT_LOG_FLUSH_DELAY_MS 600000 //Maximum time a logged fault waits in the RAM for the flash write
+#define TIMER_TABLE_ENTRIES     31      //Entries of the timer table. Together with the header two flash rows per slot
+#define SCENE_AMOUNT            8       //Stored scenes. Together with the header one flash row
+#define OCCUPANCY_CYCLE_TARGET  10      //Maximum share in percent of the motion gaps which switch the light off and on again
+#define OCCUPANCY_MIN_GAPS      16      //Gaps of an hour which are needed before the learned burn time is used
+#define OCCUPANCY_CHECKPOINT_GAPS 32    //New gaps until the occupancy histogram is written into the flash
+#define OCCUPANCY_ADAPTIVE_DEFAULT true //The learned burn time is used after a reset of the histogram
+#define TIMER_TABLE_SEGMENTS    (TIMER_TABLE_ENTRIES * 7 * 2 + 1)   //Segments of the week in the compiled timer table. Each entry and weekday uses up to two, Monday 0:00 one
+
 /********************************************************************************/
 
 //Use of X-Macros for defining errors
@@ -75,7 +104,7 @@
    ERROR(   eMuxInvalid                              ,    0xA015      ,       1     ,      1                           )
 
 #define USER_EVENT_LIST \
-    eEvtAutomaticMode_ResetBurningTimeout,\
+    eEvtAutomaticMode_MotionEdge,\
     eEvtCommTimeout,\
     eEvtTimeReceived,\
     eEvtStandby,\
@@ -83,12 +112,41 @@
     eEvtInitRegulationValue,\
     eEvtStandby_WakeUpReceived,\
     eEvtStandby_RxToggled,\
-    eEvtIR_CmdReceived,
+    eEvtIR_CmdReceived,\
+    eEvtFlashWriteDone,
+    
+//Events which are put into the high priority lane of the event queue. All others use the low priority lane.
+#define USER_EVENT_HIGH_PRIO_LIST \
+    EVT_PRIO_HIGH(eEvtSoftwareTimer)
+
+//Periods of the periodic task registry. The registered task is called directly with the timer event.
+/*             Period name      |    Software timer event    */
+#define USER_PERIODIC_TASK_LIST \
+    PERIOD(    ePeriod_2ms      ,    EVT_SW_TIMER_2MS        )\
+    PERIOD(    ePeriod_10ms     ,    EVT_SW_TIMER_10MS       )\
+    PERIOD(    ePeriod_51ms     ,    EVT_SW_TIMER_51MS       )\
+    PERIOD(    ePeriod_251ms    ,    EVT_SW_TIMER_251MS      )\
+    PERIOD(    ePeriod_1001ms   ,    EVT_SW_TIMER_1001MS     )
+
+//Functions which are measured with PROFILE_START and PROFILE_STOP
+#define USER_PROFILE_LIST \
+    PROFILE(eProfile_MeasureTick)\
+    PROFILE(eProfile_RegulationHandler)\
+    PROFILE(eProfile_MessageHandlerTick)\
+    PROFILE(eProfile_AutomaticModeHandler)\
+    PROFILE(eProfile_InfraredTimerIsr)
     
 #define USER_EVENTPARAM_LIST \
     eEvtParam_Plus,\
     eEvtParam_Minus,\
     eEvtParam_FullDrive,\
-    eEvtParam_LowDrive,
+    eEvtParam_LowDrive,\
+    eEvtParam_SceneRecall,\
+    eEvtParam_SaveUserSettings,
+
+//Infrared keys which recall a scene. The keys are the commands of the NEC remote.
+//The remote has no free key yet, so the list is empty.
+/*              Infrared key      |   Scene index   */
+#define USER_SCENE_IR_LIST
     
 #endif /* PROJECT_CONFIG_H_ */
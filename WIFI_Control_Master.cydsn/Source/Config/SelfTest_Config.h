@@ -19,6 +19,9 @@
     #define SELFTEST_C_ENABLE   1
 #endif
 
+#define SELFTEST_C_DUTY_PERCENT         2u      // Maximum CPU share of the cyclic selftests when they run before their deadline
+#define SELFTEST_C_COVERAGE_PERIOD_MS   1000u   // All cyclic selftests are done at least once in this period (in ms)
+
 //*******************************************
 //* Defines for inclusion of startup tests  *
 
@@ -46,6 +49,11 @@
 #define EXEC_CYCLIC_ADC                 0u          // Do NOT execute ADC test on LV
 #define EXEC_CYCLIC_UART                0u          // Do NOT execute UART test on LV
 
+// Each call of the cyclic selftest runs the next enabled test. A coverage cycle needs one step per test
+#define SELFTEST_C_STEPS    (EXEC_CYCLIC_CPUREG + EXEC_CYCLIC_CPUPC + EXEC_CYCLIC_TIMEBASE + EXEC_CYCLIC_RAM \
+                            + EXEC_CYCLIC_STACK + EXEC_CYCLIC_STACKOVF + EXEC_CYCLIC_FLASH + EXEC_CYCLIC_IO \
+                            + EXEC_CYCLIC_ADC + EXEC_CYCLIC_UART)
+
 #if (EXEC_STARTUP_CPUREG == 1 || EXEC_CYCLIC_CPUREG == 1 || EXEC_STARTUP_CPUPC == 1 || EXEC_CYCLIC_CPUPC == 1)
     #define HAL_SELFTEST_CPU    
 #endif
@@ -17,5 +17,30 @@
 #define USER_STATE_LIST \
    STATE(   eSM_State_Active         ,    State_Active_Entry      ,       State_Active_Root          ,      State_Active_Exit          )\
    STATE(   eSM_State_Standby        ,    State_Standby_Entry     ,       State_Standby_Root         ,      State_Standby_Exit         )
+
+#define EVT_MASK(EventId)   (1ul << (EventId))
+
+ //Events which are passed to the state manager in every state. Event IDs above 31 are always passed.
+#define USER_STATE_SUBSCRIPTION_ALWAYS(EVT) \
+   EVT(eEvtEnterResetState) EVT(eEvtState_Request)
+
+ //Events which are handled by the root function of the active state. Has to match its case labels
+#define USER_STATE_ACTIVE_EVENTS(EVT) \
+   EVT(eEvtNewRegulationValue) EVT(eEvtIR_CmdReceived) EVT(eEvtTimeReceived) EVT(eEvtSendError) \
+   EVT(eEvtCommTimeout) EVT(eEvtAutomaticMode_MotionEdge) EVT(eEvtFlashWriteDone)
+
+ //Events which are handled by the root function of the standby state. Has to match its case labels.
+ //The root function checks for the deep sleep after each event. The timer ticks ensure that the
+ //check runs at the latest with the next tick after an event which isn't subscribed.
+#define USER_STATE_STANDBY_EVENTS(EVT) \
+   EVT(eEvtStandby_RxToggled) EVT(eEvtAutomaticMode_MotionEdge) EVT(eEvtStandby_WakeUpReceived) \
+   EVT(eEvtNewRegulationValue) EVT(eEvtTimeReceived) EVT(eEvtSerialMsgReceived) EVT(eEvtSoftwareTimer) \
+   EVT(eEvtFlashWriteDone)
+
+ //Use of X-Macros for assigning the event lists to the user states
+/*                State name         |       Subscribed events      */
+#define USER_STATE_SUBSCRIPTION_LIST \
+   SUBSCRIBE(   eSM_State_Active     ,   USER_STATE_ACTIVE_EVENTS     )\
+   SUBSCRIBE(   eSM_State_Standby    ,   USER_STATE_STANDBY_EVENTS    )
  
 #endif /* STATE_LIST_H_ */
@@ -54,12 +54,22 @@ typedef struct
     bool bMotionDetectOnOff;
 }tsUserTimeSettings;
 
+typedef struct
+{
+    s16  siLatitude;        //Latitude in 1/100 degree. North is positive
+    s16  siLongitude;       //Longitude in 1/100 degree. East is positive
+    s8   scDuskOffset;      //Minutes which are added to the sunset
+    s8   scDawnOffset;      //Minutes which are added to the sunrise
+    bool bSunTimerActive;   //Virtual timer from dusk until dawn
+}tsSunTimerSettings;
+
 typedef struct
 {
     tLedValue sLedValue[DRIVE_OUTPUTS];
     tsUserTimeSettings sUserTimerSettings;
     u16  uiNtcAdcValue[DRIVE_OUTPUTS];
     bool bNightModeOnOff;
+    tsSunTimerSettings sSunTimer;   //Behind the fields of the raw legacy image
 }tRegulationValues;
 
 typedef struct
@@ -68,6 +78,8 @@ typedef struct
     bool bInNightModeTimeSlot;
     bool bInUserTimerSlot;
     bool bMotionDetected;
+    u8   ucTimerSlotOutputs;                        //Bit per output which is switched on by a user timer or the timer table
+    u8   aucTimerTableBrightness[DRIVE_OUTPUTS];    //Brightness of the timer table. Zero when no entry switches the output
 }tsAutomaticModeValues;
 
 typedef struct
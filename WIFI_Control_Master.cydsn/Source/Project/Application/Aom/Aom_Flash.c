@@ -6,74 +6,183 @@
 */
 
 
+#include <project.h>
+
 #include "OS_Flash.h"
 #include "OS_EventManager.h"
 
 #include "DR_Measure.h"
+#include "DR_Flash.h"
+#include "DR_System.h"
 
 #include "Aom_Flash.h"
+#include "Aom_Journal.h"
+#include "Aom_SettingsFormat.h"
+#include "FaultLog.h"
+#include "TimerTable.h"
+#include "Scene.h"
+#include "Occupancy.h"
+#include "Aom_Time.h"
 /****************************************** Defines ******************************************************/
+/* The system settings are stored alternately in two slots. A write goes always into the slot which isn't
+   used. The slot with the newest valid version is used at the start. A torn or failed write leaves the
+   other slot untouched. */
+#define SYSTEM_SETTINGS_SLOTS       2
+#define SYSTEM_SETTINGS_SLOT_ROWS   ((sizeof(tsSystemSettingsSlot) + CY_FLASH_SIZEOF_ROW - 1) / CY_FLASH_SIZEOF_ROW)
+#define SYSTEM_SETTINGS_SLOT_SIZE   (SYSTEM_SETTINGS_SLOT_ROWS * CY_FLASH_SIZEOF_ROW)
+#define SYSTEM_SETTINGS_CRC_SIZE    (sizeof(tsSystemSettingsSlot) - sizeof(u32))    //The CRC is the last field
+
+#define CRC32_POLYNOM               0xEDB88320
+
+typedef struct
+{
+    u32 ulVersion;                          //Incremented with each write. The newer slot wins
+    u16 uiSize;                             //Size of the settings array
+    u16 uiReserved;
+    tsSystemSettings sSettings[DRIVE_OUTPUTS];
+    u32 ulCrc;                              //CRC over the slot without the CRC field. Has to be the last field
+}tsSystemSettingsSlot;
+
 /****************************************** Variables ****************************************************/
+/* Row aligned flash area of the system settings slots. Is read volatile because the content is changed by the flash writes */
+static const volatile u8 ucSystemSettingsFlash[SYSTEM_SETTINGS_SLOTS * SYSTEM_SETTINGS_SLOT_SIZE] CY_ALIGN(CY_FLASH_SIZEOF_ROW) = {0};
+
+static bool bUserSettingsPending = false;
+static u8 ucUserSettingsRetries = 0;
+static bool bUserSettingsChanged = false;
+static u32 ulFirstChangeTick = 0;                               //Tick of the oldest change which isn't written yet
+
+static tsFlashStatistic sStatistic;
+
+static bool bSystemSettingsPending = false;
+static u8 ucSystemSettingsRetries = 0;
+static u8 ucSystemSettingsSlot = SYSTEM_SETTINGS_SLOTS - 1;     //Slot with the newest valid settings
+static u32 ulSystemSettingsVersion = 0;                         //Version of the newest valid settings
+static u8 ucSystemSettingsWriteSlot = 0;                        //Slot of the running write
+
 /****************************************** Function prototypes ******************************************/
+static bool ReadSystemSettingsSlot(u8 ucSlot, tsSystemSettingsSlot* psSlot);
+static void SetVoltageLimits(u8 ucOutputIdx);
+
 /****************************************** loacl functiones *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads a slot of the system settings from the flash and checks it.
+\return     bool - True when the size and the CRC of the slot are valid
+\param      ucSlot - Index of the slot
+\param      psSlot - Pointer to the slot which shall be filled
+***********************************************************************************/
+static bool ReadSystemSettingsSlot(u8 ucSlot, tsSystemSettingsSlot* psSlot)
+{
+    const volatile u8* pucFlash = &ucSystemSettingsFlash[ucSlot * SYSTEM_SETTINGS_SLOT_SIZE];
+    u8* pucSlot = (u8*)psSlot;
+    
+    u16 uiByteIdx;
+    for(uiByteIdx = 0; uiByteIdx < sizeof(tsSystemSettingsSlot); uiByteIdx++)
+    {
+        pucSlot[uiByteIdx] = pucFlash[uiByteIdx];
+    }
+    
+    return (psSlot->uiSize == sizeof(psSlot->sSettings)
+            && psSlot->ulCrc == Aom_Flash_CalculateCrc(psSlot, SYSTEM_SETTINGS_CRC_SIZE));
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Sets the regulation limits of the voltage calculation from the
+            system settings of the output.
+\return     none
+\param      ucOutputIdx - Index of the output
+***********************************************************************************/
+static void SetVoltageLimits(u8 ucOutputIdx)
+{
+    const tsSystemSettings* psSystemSettings = Aom_GetSystemSettingsEntry(ucOutputIdx);
+    
+    u32 ulMinVoltageLimit = DR_Measure_CalculateVoltageValue(psSystemSettings->uiMinAdcVoltage);
+    u32 ulMaxVoltageLimit = DR_Measure_CalculateVoltageValue(psSystemSettings->uiMaxAdcVoltage);
+    
+    DR_Measure_SetNewVoltageLimits(ulMinVoltageLimit, ulMaxVoltageLimit, ucOutputIdx);
+}
+
 /****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the CRC32 of the data with the initial value of the OS.
+            Is also used for the CRC of the timer table.
+\return     ulCrc - The calculated CRC
+\param      pvData - The data
+\param      uiSize - Size of the data in bytes
+***********************************************************************************/
+u32 Aom_Flash_CalculateCrc(const void* pvData, u16 uiSize)
+{
+    const u8* pucData = (const u8*)pvData;
+    u32 ulCrc = CRC_INITIAL_VALUE;
+    
+    while(uiSize--)
+    {
+        ulCrc ^= *pucData++;
+        
+        u8 ucBit;
+        for(ucBit = 0; ucBit < 8; ucBit++)
+        {
+            ulCrc = (ulCrc & 0x01) ? ((ulCrc >> 1) ^ CRC32_POLYNOM) : (ulCrc >> 1);
+        }
+    }
+    
+    return ~ulCrc;
+}
+
+
   
 //********************************************************************************
 /*!
 \author     Kraemer E.
 \date       10.11.2019
 \fn         Aom_WriteSystemSettingsInFlash
-\brief      Save actual system settings in flash memory.
+\brief      Save actual system settings in flash memory. The settings are
+            written with the next version into the unused slot. The slot is
+            only taken over when the write was verified. When a write is
+            already running the settings are written again after it.
 \return     none
 \param      none
 ***********************************************************************************/
 void Aom_Flash_WriteSystemSettingsInFlash(void)
 {       
-    /* Calculate the desired flash data size first */
-    u8 ucFlashDataSize = sizeof(tsSystemSettings) * DRIVE_OUTPUTS;
+    tsSystemSettingsSlot sSlot;
+    memset(&sSlot, 0, sizeof(sSlot));
     
-    /* Initialize the flash data array */
-    u8 ucFlashData[ucFlashDataSize];    
-    memset(&ucFlashData[0], 0, ucFlashDataSize);
+    sSlot.ulVersion = ulSystemSettingsVersion + 1;
+    sSlot.uiSize = sizeof(sSlot.sSettings);
     
-    /* Copy system settings into flash data array */
-    u8 ucDataOffset = 0;
     u8 ucOutputIdx;
     for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
     {
-        /* Get address of the entry */
-        tsSystemSettings* psSystemSettings = Aom_GetSystemSettingsEntry(ucOutputIdx);        
-        memcpy(&ucFlashData[ucDataOffset], psSystemSettings, sizeof(tsSystemSettings));
+        memcpy(&sSlot.sSettings[ucOutputIdx], Aom_GetSystemSettingsEntry(ucOutputIdx), sizeof(tsSystemSettings));
         
-        ucDataOffset += sizeof(tsSystemSettings);        
+        /* The new limits are used at once. The flash keeps the last valid settings until the write is done */
+        SetVoltageLimits(ucOutputIdx);
     }
     
-    /* When writing was successfull, change regulation values */
-    if(OS_Flash_WriteSystemSettings(&ucFlashData[0], ucFlashDataSize))
+    sSlot.ulCrc = Aom_Flash_CalculateCrc(&sSlot, SYSTEM_SETTINGS_CRC_SIZE);
+    
+    const u8 ucWriteSlot = (ucSystemSettingsSlot + 1) % SYSTEM_SETTINGS_SLOTS;
+    const u32 ulFlashRow = FLASH_ROW_OF(ucSystemSettingsFlash) + (ucWriteSlot * SYSTEM_SETTINGS_SLOT_ROWS);
+    
+    if(DR_Flash_StartWrite(eFlashJob_SystemSettings, ulFlashRow, &sSlot, sizeof(sSlot)))
     {
-        u8 ucFlashCompareData[ucFlashDataSize];
-        memset(&ucFlashCompareData[0], 0, ucFlashDataSize);
-        
-        OS_Flash_GetSystemSettings(&ucFlashCompareData[0], ucFlashDataSize);
-        
-        /* Check if flash access was successful. Memcmp returns 0 when both buffers contains the same data */
-        if(memcmp(&ucFlashData[0], &ucFlashCompareData[0], ucFlashDataSize))
-        {
-            //Faulty wait for WDT
-            while(1);
-        }
-        
-        for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
-        {
-            /* Get address of the entry */
-            tsSystemSettings* psSystemSettings = Aom_GetSystemSettingsEntry(ucOutputIdx);        
-        
-            /* Set new regulation limits to for voltage calculation */
-            u32 ulMinVoltageLimit = DR_Measure_CalculateVoltageValue(psSystemSettings->uiMinAdcVoltage);
-            u32 ulMaxVoltageLimit = DR_Measure_CalculateVoltageValue(psSystemSettings->uiMaxAdcVoltage);
-            
-            DR_Measure_SetNewVoltageLimits(ulMinVoltageLimit, ulMaxVoltageLimit, ucOutputIdx);
-        }
+        ucSystemSettingsWriteSlot = ucWriteSlot;
+        bSystemSettingsPending = false;
+    }
+    else
+    {
+        bSystemSettingsPending = true;
     }
 }
 
@@ -83,41 +192,60 @@ void Aom_Flash_WriteSystemSettingsInFlash(void)
 \author     Kraemer E.
 \date       20.01.2019
 \fn         Aom_ReadSystemSettingsFromFlash
-\brief      Read the system settings from the flash memory.
+\brief      Read the system settings from the flash memory. The valid slot with
+            the newest version is used. When no slot is valid the settings of
+            the OS flash area are taken over.
 \return     none
 \param      none
 ***********************************************************************************/
 u8 Aom_Flash_ReadSystemSettingsFromFlash(void)
 {   
     u8 ucRead = 0;
+    bool bValid = false;
     
-    /* Calculate the desired flash data size first */
-    u8 ucFlashDataSize = sizeof(tsSystemSettings) * DRIVE_OUTPUTS;
+    tsSystemSettingsSlot sSlot;
+    tsSystemSettingsSlot sNewestSlot;
     
-    /* Initialize the flash data array */
-    u8 ucFlashData[ucFlashDataSize];    
-    memset(&ucFlashData[0], 0, ucFlashDataSize);
+    /* Search the newest valid slot. The version difference handles the overflow */
+    u8 ucSlot;
+    for(ucSlot = 0; ucSlot < SYSTEM_SETTINGS_SLOTS; ucSlot++)
+    {
+        if(ReadSystemSettingsSlot(ucSlot, &sSlot)
+            && (bValid == false || (s32)(sSlot.ulVersion - sNewestSlot.ulVersion) > 0))
+        {
+            memcpy(&sNewestSlot, &sSlot, sizeof(sSlot));
+            ucSystemSettingsSlot = ucSlot;
+            bValid = true;
+        }
+    }
+    
+    if(bValid)
+    {
+        ulSystemSettingsVersion = sNewestSlot.ulVersion;
+    }
+    else
+    {
+        /* Nothing saved in the slots yet. Take over the settings of the OS flash area */
+        memset(&sNewestSlot, 0, sizeof(sNewestSlot));
+        bValid = OS_Flash_GetSystemSettings(&sNewestSlot.sSettings[0], sizeof(sNewestSlot.sSettings));
+    }
     
     /* Read user settings and if there is nothing saved, wait for answer from ESP */
-    if(OS_Flash_GetSystemSettings(&ucFlashData[0], ucFlashDataSize))
+    if(bValid)
     {
         u8 ucOutputIdx;
-        u8 ucDataOffset = 0;
         for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
         {
             /* Get address of the entry */
             tsSystemSettings* psSystemSettings = Aom_GetSystemSettingsEntry(ucOutputIdx);        
-            memcpy(psSystemSettings, &ucFlashData[ucDataOffset], sizeof(tsSystemSettings));
-            ucDataOffset += sizeof(tsSystemSettings);  
+            memcpy(psSystemSettings, &sNewestSlot.sSettings[ucOutputIdx], sizeof(tsSystemSettings));
         
             if(psSystemSettings->uiMaxAdcVoltage || psSystemSettings->uiMaxAdcCurrent)
             {
                 ucRead = 0x01 << ucOutputIdx;
                 
                 /* Set new regulation limits to for voltage calculation */
-                u32 ulMinVoltageLimit = DR_Measure_CalculateVoltageValue(psSystemSettings->uiMinAdcVoltage);
-                u32 ulMaxVoltageLimit = DR_Measure_CalculateVoltageValue(psSystemSettings->uiMaxAdcVoltage);
-                DR_Measure_SetNewVoltageLimits(ulMinVoltageLimit, ulMaxVoltageLimit, ucOutputIdx);
+                SetVoltageLimits(ucOutputIdx);
             }
         }
     }
@@ -126,18 +254,212 @@ u8 Aom_Flash_ReadSystemSettingsFromFlash(void)
 }
 
 
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Is called on each change of the user settings. The write is delayed
+            until the changes stop for SAVE_IN_FLASH_TIMEOUT. When the oldest
+            change waits longer than SAVE_IN_FLASH_MAX_DEFER the settings are
+            written at once.
+\return     bool - True when the write was started. Otherwise the caller has to
+                   restart the save timeout.
+\param      none
+***********************************************************************************/
+bool Aom_Flash_UserSettingsChanged(void)
+{
+    const u32 ulTick = DR_System_GetTickMs();
+    
+    if(bUserSettingsChanged == false)
+    {
+        bUserSettingsChanged = true;
+        ulFirstChangeTick = ulTick;
+    }
+    else if(ulTick - ulFirstChangeTick >= SAVE_IN_FLASH_MAX_DEFER)
+    {
+        if(sStatistic.uiForcedWrites < 0xFFFF)
+        {
+            sStatistic.uiForcedWrites++;
+        }
+        
+        Aom_Flash_WriteUserSettingsInFlash();
+        return true;
+    }
+    
+    return false;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Writes the changed user settings without waiting for the save
+            timeout. Is called when the standby is entered and for each change
+            in standby.
+\return     none
+\param      none
+***********************************************************************************/
+void Aom_Flash_FlushUserSettings(void)
+{
+    if(bUserSettingsChanged)
+    {
+        if(sStatistic.uiStandbyWrites < 0xFFFF)
+        {
+            sStatistic.uiStandbyWrites++;
+        }
+        
+        Aom_Flash_WriteUserSettingsInFlash();
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the write statistic of the settings.
+\return     tsFlashStatistic - Pointer to the statistic
+\param      none
+***********************************************************************************/
+const tsFlashStatistic* Aom_Flash_GetStatistic(void)
+{
+    return &sStatistic;
+}
+
+
 //********************************************************************************
 /*!
 \author     Kraemer E.
 \date       20.01.2019
-\brief      Save actual user settings in flash memory. Function is called by a
-            software timer
+\brief      Save actual user settings in flash memory. Function is called by the
+            root state when the save timeout elapsed, by the maximum deferral
+            or by the standby entry. Only the changed parts of the settings are
+            appended to the journal and programmed in the idle time of the main
+            task. When a write is already running the settings are written
+            again after it. Shall only be called from the main context, like
+            the write done handling.
 \return     none
 \param      none
 ***********************************************************************************/
 void Aom_Flash_WriteUserSettingsInFlash(void)
 {    
-    OS_Flash_WriteUserSettings(Aom_GetRegulationSettings(), sizeof(tRegulationValues));
+    bUserSettingsChanged = false;
+    
+    /* Only the persistent fields are written */
+    u8 ucImage[USER_SETTINGS_PACKED_SIZE];
+    Aom_SettingsFormat_Pack(Aom_GetRegulationSettings(), ucImage);
+    
+    /* Skip the write when the changes were taken back */
+    if(bUserSettingsPending == false && Aom_Journal_IsUnchanged(ucImage))
+    {
+        if(sStatistic.uiSkippedIdentical < 0xFFFF)
+        {
+            sStatistic.uiSkippedIdentical++;
+        }
+        return;
+    }
+    
+    if(Aom_Journal_Commit(ucImage))
+    {
+        bUserSettingsPending = false;
+    }
+    else
+    {
+        bUserSettingsPending = true;
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Handles the end of a flash write job. A failed job is retried and a
+            pending write of the system settings, the user settings or the
+            fault log is started.
+\return     none
+\param      eJob - The finished job
+\param      bSuccess - True when all rows were programmed and verified
+***********************************************************************************/
+void Aom_Flash_WriteDone(teFlashJob eJob, bool bSuccess)
+{
+    if(eJob == eFlashJob_SystemSettings)
+    {
+        /* The written slot is used from now on. After a failure the old slot stays valid */
+        if(bSuccess)
+        {
+            ucSystemSettingsSlot = ucSystemSettingsWriteSlot;
+            ulSystemSettingsVersion++;
+            ucSystemSettingsRetries = 0;
+            
+            if(sStatistic.uiSystemWrites < 0xFFFF)
+            {
+                sStatistic.uiSystemWrites++;
+            }
+        }
+        else if(ucSystemSettingsRetries < FLASH_WRITE_RETRIES)
+        {
+            ucSystemSettingsRetries++;
+            bSystemSettingsPending = true;
+        }
+    }
+    else if(eJob == eFlashJob_FaultLog)
+    {
+        FaultLog_WriteDone(bSuccess);
+    }
+    else if(eJob == eFlashJob_TimerTable)
+    {
+        TimerTable_WriteDone(bSuccess);
+    }
+    else if(eJob == eFlashJob_Scene)
+    {
+        Scene_WriteDone(bSuccess);
+    }
+    else if(eJob == eFlashJob_Occupancy)
+    {
+        Occupancy_WriteDone(bSuccess);
+    }
+    else if(eJob == eFlashJob_UserSettings)
+    {
+        Aom_Journal_WriteDone(bSuccess);
+        
+        if(bSuccess)
+        {
+            ucUserSettingsRetries = 0;
+            
+            if(sStatistic.uiUserWrites < 0xFFFF)
+            {
+                sStatistic.uiUserWrites++;
+            }
+        }
+        else if(ucUserSettingsRetries < FLASH_WRITE_RETRIES)
+        {
+            ucUserSettingsRetries++;
+            bUserSettingsPending = true;
+        }
+    }
+    
+    if(bSuccess == false && sStatistic.uiFailedWrites < 0xFFFF)
+    {
+        sStatistic.uiFailedWrites++;
+    }
+    
+    /* The calibration is written first */
+    if(bSystemSettingsPending)
+    {
+        Aom_Flash_WriteSystemSettingsInFlash();
+    }
+    else if(bUserSettingsPending)
+    {
+        Aom_Flash_WriteUserSettingsInFlash();
+    }
+    else if(FaultLog_StartPendingWrite() == false
+            && TimerTable_StartPendingWrite() == false
+            && Scene_StartPendingWrite() == false)
+    {
+        Occupancy_StartPendingWrite();
+    }
 }
 
 
@@ -151,19 +473,33 @@ void Aom_Flash_WriteUserSettingsInFlash(void)
 ***********************************************************************************/
 void Aom_Flash_ReadUserSettingsFromFlash(void)
 {   
-    /* Read user settings and if there is nothing saved, wait for answer from ESP */
-    if(OS_Flash_GetUserSettings(Aom_GetRegulationSettings(), sizeof(tRegulationValues)) == false)
-    {       
-        /* No config found -> Set default values */
-        tRegulationValues* psRegulationVal = Aom_GetRegulationSettings();
+    tRegulationValues* psRegulationVal = Aom_GetRegulationSettings();
+    u8 ucImage[USER_SETTINGS_PACKED_SIZE];
+    
+    /* Rebuild the packed image from the journal and unpack it. Older versions are migrated */
+    if(Aom_Journal_Load(ucImage) && Aom_SettingsFormat_Unpack(ucImage, sizeof(ucImage), psRegulationVal))
+    {
+        /* Settings are restored */
+    }
+    else
+    {
+        /* Nothing saved yet. Take over the raw settings of the OS flash area or use the default values */
+        tRegulationValues sLegacy;
         
-        psRegulationVal->sUserTimerSettings.sTimer[0].ucHourSet = 6;
-        psRegulationVal->sUserTimerSettings.sTimer[0].ucHourClear = 21;
-        psRegulationVal->sUserTimerSettings.sTimer[0].ucMinSet = 0;
-        psRegulationVal->sUserTimerSettings.sTimer[0].ucMinClear = 0;
-        psRegulationVal->sUserTimerSettings.ucSetTimerBinary |= 0x01 << 0;
+        if(OS_Flash_GetUserSettings(&sLegacy, sizeof(tRegulationValues)))
+        {
+            Aom_SettingsFormat_MigrateLegacy(&sLegacy, psRegulationVal);
+        }
+        else
+        {
+            /* No config found -> Set default values */
+            Aom_SettingsFormat_SetDefaults(psRegulationVal);
+        }
         
         /* Read last saved brightness value, in this case the LED should always be OFF */
         //Aom_SetCustomValue(sRegulationValues.sLedValue.ucPercentValue, false);
     }
+    
+    /* Prepare the time slot check of the automatic mode */
+    Aom_Time_CompileUserTimerSchedule();
 }
@@ -20,8 +20,24 @@ extern "C"
 
 #include "BaseTypes.h"
 #include "Aom.h"
+#include "DR_Flash.h"
 
+typedef struct
+{
+    u16 uiUserWrites;           //Successful writes of the user settings journal
+    u16 uiSystemWrites;         //Successful writes of a system settings slot
+    u16 uiFailedWrites;         //Write jobs which couldn't be verified
+    u16 uiSkippedIdentical;     //Commits which were skipped because the flash holds the same data
+    u16 uiForcedWrites;         //Commits which were started by the maximum deferral
+    u16 uiStandbyWrites;        //Commits which were started by entering the standby
+}tsFlashStatistic;
+
+u32  Aom_Flash_CalculateCrc(const void* pvData, u16 uiSize);
+bool Aom_Flash_UserSettingsChanged(void);
+void Aom_Flash_FlushUserSettings(void);
+const tsFlashStatistic* Aom_Flash_GetStatistic(void);
 void Aom_Flash_WriteUserSettingsInFlash(void);
+void Aom_Flash_WriteDone(teFlashJob eJob, bool bSuccess);
 void Aom_Flash_ReadUserSettingsFromFlash(void);
 void Aom_Flash_WriteSystemSettingsInFlash(void);
 u8   Aom_Flash_ReadSystemSettingsFromFlash(void);
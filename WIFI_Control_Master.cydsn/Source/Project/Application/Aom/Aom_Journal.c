@@ -0,0 +1,421 @@
+/* ========================================
+ *
+ * Copyright Eduard Kraemer, 2026
+ *
+ * ========================================
+*/
+
+#include <project.h>
+
+#include "DR_Flash.h"
+
+#include "Aom_Journal.h"
+/****************************************** Defines ******************************************************/
+/* The packed user settings image is split into chunks. Each chunk is one key of the journal. A record holds one chunk
+   with its sequence number and a CRC. The records of a commit are written into the next unused row of the
+   active page. When the page is full, all chunks are written as a snapshot into the next page. The flash is
+   only written row wise and each write erases the row first. Therefore a row with valid records is never
+   written again until its page is reused, so a torn write can't destroy committed records. */
+#define JOURNAL_ROWS                (JOURNAL_PAGES * JOURNAL_ROWS_PER_PAGE)
+#define JOURNAL_RECORDS_PER_ROW     (CY_FLASH_SIZEOF_ROW / sizeof(tsJournalRecord))
+#define JOURNAL_RECORDS_PER_PAGE    (JOURNAL_RECORDS_PER_ROW * JOURNAL_ROWS_PER_PAGE)
+#define JOURNAL_CHUNKS              ((JOURNAL_IMAGE_SIZE + JOURNAL_CHUNK_SIZE - 1) / JOURNAL_CHUNK_SIZE)
+
+#define CRC16_INITIAL_VALUE         0xFFFF
+#define CRC16_POLYNOM               0x1021
+
+typedef struct
+{
+    u32 ulSequence;
+    u8  ucKey;                          //Chunk index + 1. Zero or an unknown key marks an empty record
+    u8  ucLength;
+    u16 uiCrc;                          //CRC over the record with a zero CRC field
+    u8  ucData[JOURNAL_CHUNK_SIZE];
+}tsJournalRecord;
+
+typedef struct
+{
+    u8  ucPage;                         //Active page
+    u16 uiNextRecord;                   //Next free record in the active page
+}tsJournalHead;
+
+/****************************************** Variables ****************************************************/
+/* Row aligned flash area of the journal. Is read volatile because the content is changed by the flash writes */
+static const volatile u8 ucJournalFlash[JOURNAL_ROWS * CY_FLASH_SIZEOF_ROW] CY_ALIGN(CY_FLASH_SIZEOF_ROW) = {0};
+
+static tsJournalStatistic sStatistic;
+static tsJournalHead sHead = {0, 0};
+static tsJournalHead sPendingHead = {0, 0};
+
+static u8 ucCommitted[JOURNAL_IMAGE_SIZE];  //Content of the journal
+static u8 ucPending[JOURNAL_IMAGE_SIZE];    //Content of the journal after the running write
+
+static tsJournalRecord sWriteRows[FLASH_JOB_MAX_ROWS * JOURNAL_RECORDS_PER_ROW];
+static u8   ucWriteRowCnt = 0;
+static u8   ucWriteFirstRow = 0;        //First journal row of the running write
+static u32  ulNextSequence = 1;
+static bool bWriteRunning = false;
+static bool bCompactNext = false;       //Set after a failed write. The next commit starts a clean page
+
+/****************************************** Function prototypes ******************************************/
+static u16 CalculateCrc(const tsJournalRecord* psRecord);
+static bool ReadRecord(u8 ucPage, u16 uiRecordIdx, tsJournalRecord* psRecord);
+static void BuildRecord(tsJournalRecord* psRecord, u8 ucChunkIdx, const u8* pucImage);
+static bool StartWrite(u8 ucFirstRow, u8 ucRowCnt);
+static bool StartCompaction(const u8* pucImage);
+
+/****************************************** loacl functiones *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the CRC16-CCITT of the record. The CRC field itself is
+            taken as zero.
+\return     uiCrc - The calculated CRC
+\param      psRecord - The record
+***********************************************************************************/
+static u16 CalculateCrc(const tsJournalRecord* psRecord)
+{
+    tsJournalRecord sRecord = *psRecord;
+    sRecord.uiCrc = 0;
+    
+    const u8* pucData = (const u8*)&sRecord;
+    u16 uiCrc = CRC16_INITIAL_VALUE;
+    
+    u8 ucByteIdx;
+    for(ucByteIdx = 0; ucByteIdx < sizeof(sRecord); ucByteIdx++)
+    {
+        uiCrc ^= (u16)pucData[ucByteIdx] << 8;
+        
+        u8 ucBit;
+        for(ucBit = 0; ucBit < 8; ucBit++)
+        {
+            uiCrc = (uiCrc & 0x8000) ? ((uiCrc << 1) ^ CRC16_POLYNOM) : (uiCrc << 1);
+        }
+    }
+    
+    return uiCrc;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads a record from the flash and checks it.
+\return     bool - True when the record is valid
+\param      ucPage - Page of the record
+\param      uiRecordIdx - Index of the record in the page
+\param      psRecord - Pointer to the record which shall be filled
+***********************************************************************************/
+static bool ReadRecord(u8 ucPage, u16 uiRecordIdx, tsJournalRecord* psRecord)
+{
+    const volatile u8* pucFlash = &ucJournalFlash[((ucPage * JOURNAL_RECORDS_PER_PAGE) + uiRecordIdx) * sizeof(tsJournalRecord)];
+    u8* pucRecord = (u8*)psRecord;
+    
+    u8 ucByteIdx;
+    for(ucByteIdx = 0; ucByteIdx < sizeof(tsJournalRecord); ucByteIdx++)
+    {
+        pucRecord[ucByteIdx] = pucFlash[ucByteIdx];
+    }
+    
+    return (psRecord->ucKey > 0 && psRecord->ucKey <= JOURNAL_CHUNKS
+            && psRecord->ucLength <= JOURNAL_CHUNK_SIZE
+            && psRecord->uiCrc == CalculateCrc(psRecord));
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Fills a record with the chunk of the image and the next sequence
+            number.
+\return     none
+\param      psRecord - The record which shall be filled
+\param      ucChunkIdx - Index of the chunk
+\param      pucImage - The settings image
+***********************************************************************************/
+static void BuildRecord(tsJournalRecord* psRecord, u8 ucChunkIdx, const u8* pucImage)
+{
+    const u16 uiOffset = ucChunkIdx * JOURNAL_CHUNK_SIZE;
+    u8 ucLength = JOURNAL_CHUNK_SIZE;
+    
+    if(uiOffset + ucLength > JOURNAL_IMAGE_SIZE)
+    {
+        ucLength = JOURNAL_IMAGE_SIZE - uiOffset;
+    }
+    
+    memset(psRecord, 0, sizeof(tsJournalRecord));
+    psRecord->ulSequence = ulNextSequence++;
+    psRecord->ucKey = ucChunkIdx + 1;
+    psRecord->ucLength = ucLength;
+    memcpy(psRecord->ucData, &pucImage[uiOffset], ucLength);
+    psRecord->uiCrc = CalculateCrc(psRecord);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Starts the flash job for the rows in the write buffer.
+\return     bool - True when the job was started
+\param      ucFirstRow - First row of the journal area
+\param      ucRowCnt - Amount of rows in the write buffer
+***********************************************************************************/
+static bool StartWrite(u8 ucFirstRow, u8 ucRowCnt)
+{
+    const u32 ulFlashRow = FLASH_ROW_OF(ucJournalFlash) + ucFirstRow;
+    
+    if(DR_Flash_StartWrite(eFlashJob_UserSettings, ulFlashRow, sWriteRows, ucRowCnt * CY_FLASH_SIZEOF_ROW))
+    {
+        ucWriteFirstRow = ucFirstRow;
+        ucWriteRowCnt = ucRowCnt;
+        bWriteRunning = true;
+    }
+    
+    return bWriteRunning;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Writes all chunks as a snapshot into the first rows of the next page.
+\return     bool - True when the write was started
+\param      pucImage - The settings image which shall be written
+***********************************************************************************/
+static bool StartCompaction(const u8* pucImage)
+{
+    /* The snapshot has to fit into one flash job */
+    if(JOURNAL_CHUNKS > _countof(sWriteRows) || JOURNAL_CHUNKS > JOURNAL_RECORDS_PER_PAGE)
+    {
+        return false;
+    }
+    
+    memset(sWriteRows, 0, sizeof(sWriteRows));
+    
+    u8 ucChunkIdx;
+    for(ucChunkIdx = 0; ucChunkIdx < JOURNAL_CHUNKS; ucChunkIdx++)
+    {
+        BuildRecord(&sWriteRows[ucChunkIdx], ucChunkIdx, pucImage);
+    }
+    
+    sPendingHead.ucPage = (sHead.ucPage + 1) % JOURNAL_PAGES;
+    sPendingHead.uiNextRecord = JOURNAL_CHUNKS;
+    
+    const u8 ucRowCnt = (JOURNAL_CHUNKS + JOURNAL_RECORDS_PER_ROW - 1) / JOURNAL_RECORDS_PER_ROW;
+    
+    return StartWrite(sPendingHead.ucPage * JOURNAL_ROWS_PER_PAGE, ucRowCnt);
+}
+
+/****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Rebuilds the settings image with one linear scan over all records. The
+            record with the highest sequence number of each key wins. The head
+            is placed behind the newest record.
+\return     bool - True when the journal contains at least one record
+\param      pucImage - The settings image of JOURNAL_IMAGE_SIZE bytes which
+                       shall be filled
+***********************************************************************************/
+bool Aom_Journal_Load(u8* pucImage)
+{
+    u32 ulKeySequence[JOURNAL_CHUNKS];
+    memset(ulKeySequence, 0, sizeof(ulKeySequence));
+    memset(ucCommitted, 0, sizeof(ucCommitted));
+    memset(&sStatistic, 0, sizeof(sStatistic));
+    
+    u32 ulMaxSequence = 0;
+    tsJournalRecord sRecord;
+    
+    u8 ucPage;
+    for(ucPage = 0; ucPage < JOURNAL_PAGES; ucPage++)
+    {
+        u16 uiRecordIdx;
+        for(uiRecordIdx = 0; uiRecordIdx < JOURNAL_RECORDS_PER_PAGE; uiRecordIdx++)
+        {
+            if(ReadRecord(ucPage, uiRecordIdx, &sRecord))
+            {
+                const u8 ucChunkIdx = sRecord.ucKey - 1;
+                
+                if(sRecord.ulSequence > ulKeySequence[ucChunkIdx])
+                {
+                    ulKeySequence[ucChunkIdx] = sRecord.ulSequence;
+                    memcpy(&ucCommitted[ucChunkIdx * JOURNAL_CHUNK_SIZE], sRecord.ucData, sRecord.ucLength);
+                }
+                
+                if(sRecord.ulSequence > ulMaxSequence)
+                {
+                    ulMaxSequence = sRecord.ulSequence;
+                    sHead.ucPage = ucPage;
+                    sHead.uiNextRecord = uiRecordIdx + 1;
+                }
+            }
+        }
+    }
+    
+    ulNextSequence = ulMaxSequence + 1;
+    
+    sStatistic.uiFreeRecords = JOURNAL_RECORDS_PER_PAGE - sHead.uiNextRecord;
+    
+    if(ulMaxSequence == 0)
+    {
+        return false;
+    }
+    
+    memcpy(pucImage, ucCommitted, JOURNAL_IMAGE_SIZE);
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Writes the changed chunks of the image into the next unused row.
+            When the records don't fit into the active page a snapshot is
+            written into the next page.
+\return     bool - False when the write couldn't be started. True when nothing
+                   changed or the write was started.
+\param      pucImage - The current settings image
+***********************************************************************************/
+bool Aom_Journal_Commit(const u8* pucImage)
+{
+    if(bWriteRunning)
+    {
+        return false;
+    }
+    
+    /* Collect the changed chunks */
+    u8 ucChangedChunks[JOURNAL_CHUNKS];
+    u8 ucChangedCnt = 0;
+    
+    u8 ucChunkIdx;
+    for(ucChunkIdx = 0; ucChunkIdx < JOURNAL_CHUNKS; ucChunkIdx++)
+    {
+        const u16 uiOffset = ucChunkIdx * JOURNAL_CHUNK_SIZE;
+        const u16 uiLength = (uiOffset + JOURNAL_CHUNK_SIZE > JOURNAL_IMAGE_SIZE) ? (JOURNAL_IMAGE_SIZE - uiOffset) : JOURNAL_CHUNK_SIZE;
+        
+        if(memcmp(&pucImage[uiOffset], &ucCommitted[uiOffset], uiLength))
+        {
+            ucChangedChunks[ucChangedCnt++] = ucChunkIdx;
+        }
+    }
+    
+    if(ucChangedCnt == 0 && bCompactNext == false)
+    {
+        return true;
+    }
+    
+    memcpy(ucPending, pucImage, JOURNAL_IMAGE_SIZE);
+    
+    /* The records start always in an unused row. A partly used row keeps its records untouched */
+    const u16 uiFirstRecord = ((sHead.uiNextRecord + JOURNAL_RECORDS_PER_ROW - 1) / JOURNAL_RECORDS_PER_ROW) * JOURNAL_RECORDS_PER_ROW;
+    
+    if(bCompactNext || ucChangedCnt > JOURNAL_RECORDS_PER_ROW || uiFirstRecord + ucChangedCnt > JOURNAL_RECORDS_PER_PAGE)
+    {
+        return StartCompaction(pucImage);
+    }
+    
+    memset(sWriteRows, 0, sizeof(sWriteRows));
+    
+    u8 ucRecordIdx;
+    for(ucRecordIdx = 0; ucRecordIdx < ucChangedCnt; ucRecordIdx++)
+    {
+        BuildRecord(&sWriteRows[ucRecordIdx], ucChangedChunks[ucRecordIdx], pucImage);
+    }
+    
+    sPendingHead.ucPage = sHead.ucPage;
+    sPendingHead.uiNextRecord = uiFirstRecord + ucChangedCnt;
+    
+    return StartWrite((sHead.ucPage * JOURNAL_ROWS_PER_PAGE) + (uiFirstRecord / JOURNAL_RECORDS_PER_ROW), 1);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Checks if the image is equal to the content of the journal
+            including a running write. After a failed write the journal has to
+            be written again.
+\return     bool - True when a commit wouldn't write anything
+\param      pucImage - The current settings image
+***********************************************************************************/
+bool Aom_Journal_IsUnchanged(const u8* pucImage)
+{
+    const u8* pucJournal = bWriteRunning ? ucPending : ucCommitted;
+    
+    return (bCompactNext == false && memcmp(pucImage, pucJournal, JOURNAL_IMAGE_SIZE) == 0);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Takes over the written records when the flash job was successful.
+            After a failure the next commit writes a snapshot into a clean page.
+\return     none
+\param      bSuccess - True when all rows were programmed and verified
+***********************************************************************************/
+void Aom_Journal_WriteDone(bool bSuccess)
+{
+    if(bWriteRunning == false)
+    {
+        return;
+    }
+    
+    bWriteRunning = false;
+    
+    if(bSuccess)
+    {
+        if(sPendingHead.ucPage != sHead.ucPage && sStatistic.uiCompactions < 0xFFFF)
+        {
+            sStatistic.uiCompactions++;
+        }
+        
+        sHead = sPendingHead;
+        memcpy(ucCommitted, ucPending, JOURNAL_IMAGE_SIZE);
+        bCompactNext = false;
+        
+        sStatistic.uiFreeRecords = JOURNAL_RECORDS_PER_PAGE - sHead.uiNextRecord;
+    }
+    else
+    {
+        bCompactNext = true;
+    }
+    
+    /* Each programmed row was erased before */
+    u8 ucRowIdx;
+    for(ucRowIdx = 0; ucRowIdx < ucWriteRowCnt; ucRowIdx++)
+    {
+        u16* puiRowWrites = &sStatistic.auiRowWrites[ucWriteFirstRow + ucRowIdx];
+        
+        if(*puiRowWrites < 0xFFFF)
+        {
+            (*puiRowWrites)++;
+        }
+    }
+    
+    sStatistic.ulRowWrites += ucWriteRowCnt;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the write statistic of the journal.
+\return     tsJournalStatistic - Pointer to the statistic
+\param      none
+***********************************************************************************/
+const tsJournalStatistic* Aom_Journal_GetStatistic(void)
+{
+    return &sStatistic;
+}
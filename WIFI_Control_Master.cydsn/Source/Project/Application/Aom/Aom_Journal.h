@@ -0,0 +1,39 @@
+/* ========================================
+ *
+ * Copyright Eduard Kraemer, 2026
+ *
+ * ========================================
+*/
+
+#ifndef _AOM_JOURNAL_H_
+#define _AOM_JOURNAL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif   
+
+#include "BaseTypes.h"
+#include "Aom_SettingsFormat.h"
+
+#define JOURNAL_IMAGE_SIZE      USER_SETTINGS_PACKED_SIZE   //Size of the image which is stored in the journal
+
+typedef struct
+{
+    u32 ulRowWrites;                                        //Programmed rows since the start
+    u16 uiCompactions;                                      //Page changes since the start
+    u16 uiFreeRecords;                                      //Free records in the active page
+    u16 auiRowWrites[JOURNAL_PAGES * JOURNAL_ROWS_PER_PAGE];//Erase and program cycles of each row since the start
+}tsJournalStatistic;
+
+bool Aom_Journal_Load(u8* pucImage);
+bool Aom_Journal_Commit(const u8* pucImage);
+bool Aom_Journal_IsUnchanged(const u8* pucImage);
+void Aom_Journal_WriteDone(bool bSuccess);
+const tsJournalStatistic* Aom_Journal_GetStatistic(void);
+
+#ifdef __cplusplus
+}
+#endif    
+
+#endif //_AOM_JOURNAL_H_
@@ -9,6 +9,7 @@
 
 #include "OS_EventManager.h"
 #include "OS_ErrorHandler.h"
+#include "EventQueue.h"
 
 #include "DR_Regulation.h"
 #include "DR_ErrorDetection.h"
@@ -23,6 +24,7 @@
 /****************************************** Function prototypes ******************************************/
 static bool ValidatePercentValue(u8* pucValue);
 static void SetCustomValue(u8 ucBrightnessValue, bool bLedStatus, bool bInitMenuActive, u8 ucOutputIdx);
+static bool SetBrightnessValue(u8 ucBrightnessValue, bool bInitMenuActive, u8 ucOutputIdx);
 
 /****************************************** loacl functiones *********************************************/
 #if (WITHOUT_REGULATION == false)
@@ -80,32 +82,96 @@ static void SetCustomValue(u8 ucBrightnessValue, bool bLedStatus, bool bInitMenu
         teEventParam eParam = (bLedStatus == OFF) ? eEvtParam_RegulationStop : eEvtParam_RegulationStart;
 
         /* Request a regulation state-change */
-        OS_EVT_PostEvent(eEvtNewRegulationValue, eParam, ucOutputIdx);
+        EventQueue_PostEvent(eEvtNewRegulationValue, eParam, ucOutputIdx, eEvtPost_LatestWins);
         
         
         /* Check first if values are new values */
-        if(ucBrightnessValue != psLedVal->ucPercentValue)
+        if(SetBrightnessValue(ucBrightnessValue, bInitMenuActive, ucOutputIdx))
         {
-            if(ValidatePercentValue(&ucBrightnessValue))
-            {
-                /* Set customised percent value */
-                psLedVal->ucPercentValue = ucBrightnessValue;
-                        
-                /* Calculate requested voltage value */
-                u16 uiReqVoltage = DR_Measure_CalculateVoltageFromPercent(ucBrightnessValue, bInitMenuActive, ucOutputIdx);
-                
-                /* Calculate requested ADC value */
-                psLedVal->uiReqVoltageAdc = DR_Measure_CalculateAdcValue(uiReqVoltage,0);
-                            
-                /* Start with event */
-                OS_EVT_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, ucOutputIdx);
-            }
+            /* Start with event */
+            EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, ucOutputIdx, eEvtPost_Unique);
         }
     }
 }
 
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Saves a new brightness and calculates its requested ADC value.
+\return     bool - True when the brightness has changed
+\param      ucBrightnessValue - The brightness in percent
+\param      bInitMenuActive - True when the init menu is active
+\param      ucOutputIdx - The output which shall be changed
+***********************************************************************************/
+static bool SetBrightnessValue(u8 ucBrightnessValue, bool bInitMenuActive, u8 ucOutputIdx)
+{
+    tLedValue* psLedVal = Aom_GetOutputsSettingsEntry(ucOutputIdx);
+    
+    if(ucBrightnessValue != psLedVal->ucPercentValue && ValidatePercentValue(&ucBrightnessValue))
+    {
+        /* Set customised percent value */
+        psLedVal->ucPercentValue = ucBrightnessValue;
+                
+        /* Calculate requested voltage value */
+        u16 uiReqVoltage = DR_Measure_CalculateVoltageFromPercent(ucBrightnessValue, bInitMenuActive, ucOutputIdx);
+        
+        /* Calculate requested ADC value */
+        psLedVal->uiReqVoltageAdc = DR_Measure_CalculateAdcValue(uiReqVoltage,0);
+        
+        return true;
+    }
+    
+    return false;
+}
+
 /****************************************** External visible functiones **********************************/
 
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Sets the brightness and the status of all outputs at once. Only one
+            regulation event is posted, so all outputs start to fade in the
+            same regulation cycle.
+\return     none
+\param      pucBrightness - Array of DRIVE_OUTPUTS with the brightness in percent
+\param      ucOutputsOn - Bit per output which is switched on
+\param      uiFadeTimeMs - Time until the outputs reach the new values
+***********************************************************************************/
+void Aom_Regulation_SetAllOutputs(const u8* pucBrightness, u8 ucOutputsOn, u16 uiFadeTimeMs)
+{
+    bool bChanged = false;
+    
+    u8 ucOutputIdx;
+    for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
+    {
+        tLedValue* psLedVal = Aom_GetOutputsSettingsEntry(ucOutputIdx);
+        const bool bLedStatus = (ucOutputsOn & (0x01 << ucOutputIdx)) ? ON : OFF;
+        
+        if(psLedVal->bStatus != bLedStatus)
+        {
+            psLedVal->bStatus = bLedStatus;
+            bChanged = true;
+        }
+        
+        if(SetBrightnessValue(pucBrightness[ucOutputIdx], false, ucOutputIdx))
+        {
+            bChanged = true;
+        }
+    }
+    
+    /* Appended, because the second parameter is the fade time and not the output index like
+       in the events of a single output. Latest wins would mix them up */
+    EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_SceneRecall, uiFadeTimeMs, eEvtPost_Append);
+    
+    /* Save the new values with the user settings */
+    if(bChanged)
+    {
+        EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, DRIVE_OUTPUTS, eEvtPost_Unique);
+    }
+}
+
 
 //********************************************************************************
 /*!
@@ -243,6 +309,19 @@ void Aom_Regulation_CheckRequestValues(u8 ucBrightnessValue, bool bLedStatus, bo
     if(eAutoState != eStateDisabled)
     {
         bLedStatus = bAutomaticLedState;
+        
+        /* In the time slots only the outputs of the active timers are switched on */
+        if(eAutoState != eStateAutomaticMode_3 && ucOutputIdx < DRIVE_OUTPUTS
+            && (psAutomaticModeVal->ucTimerSlotOutputs & (0x01 << ucOutputIdx)) == 0)
+        {
+            bLedStatus = OFF;
+        }
+        
+        /* The timer table sets the brightness of its outputs */
+        if(ucOutputIdx < DRIVE_OUTPUTS && psAutomaticModeVal->aucTimerTableBrightness[ucOutputIdx])
+        {
+            ucBrightnessValue = psAutomaticModeVal->aucTimerTableBrightness[ucOutputIdx];
+        }
     }
     
     /* Reduce brightness when night mode time slot is active */
@@ -269,7 +348,7 @@ void Aom_Regulation_SetAutomaticModeStatus(bool bAutomaticModeStatus)
         psRegVal->sUserTimerSettings.bAutomaticModeActive = bAutomaticModeStatus;
         
         /* Post event to start the timer for saving the new regulation value into the flash */
-        OS_EVT_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, eEvtParam_None);
+        EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, eEvtParam_None, eEvtPost_Unique);
     }
 }
 
@@ -290,7 +369,7 @@ void Aom_Regulation_SetNightModeStatus(bool bNightModeOnOff)
         psRegVal->bNightModeOnOff = bNightModeOnOff;
     
         /* Post event to start the timer for saving the new regulation value into the flash */
-        OS_EVT_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, eEvtParam_None);
+        EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, eEvtParam_None, eEvtPost_Unique);
     }
 }
 
@@ -313,7 +392,7 @@ void Aom_Regulation_SetMotionDectionStatus(bool bMotionDetectionOnOff, u8 ucBurn
         psRegVal->sUserTimerSettings.ucBurningTime = ucBurnTime;
     
         /* Post event to start the timer for saving the new regulation value into the flash */
-        OS_EVT_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, eEvtParam_None);
+        EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, eEvtParam_None, eEvtPost_Unique);
     }
 }
 
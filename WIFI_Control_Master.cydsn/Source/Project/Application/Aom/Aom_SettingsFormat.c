@@ -0,0 +1,274 @@
+/* ========================================
+ *
+ * Copyright Eduard Kraemer, 2026
+ *
+ * ========================================
+*/
+
+#include <project.h>
+
+#include "Aom_SettingsFormat.h"
+/****************************************** Defines ******************************************************/
+/* The packed image holds only the persistent user settings. The ADC values are measured at run-time and
+   aren't stored. The counts of the outputs and timers are part of the header. Stored entries which aren't
+   used by this firmware are skipped. Missing entries and fields keep their default value.
+   When the format changes, increment USER_SETTINGS_FORMAT_VERSION, append the new fields behind the old
+   ones and read them only from images with the new version. Older images keep the defaults of the new
+   fields. A field which changes its meaning gets a conversion for the older versions in the unpack. */
+typedef struct
+{
+    const u8* pucData;
+    u16 uiSize;
+    u16 uiPos;
+}tsImageReader;
+
+/****************************************** Variables ****************************************************/
+static const tsTimeFormat sDefaultTimer = {6, 0, 21, 0};    //Default of the first user timer
+
+/****************************************** Function prototypes ******************************************/
+static u8 ReadByte(tsImageReader* psReader, u8 ucDefault);
+static u16 ReadWord(tsImageReader* psReader, u16 uiDefault);
+
+/****************************************** loacl functiones *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads the next byte of the image.
+\return     u8 - The read byte or the default value when the image ends
+\param      psReader - The reader of the image
+\param      ucDefault - Value which is returned behind the end of the image
+***********************************************************************************/
+static u8 ReadByte(tsImageReader* psReader, u8 ucDefault)
+{
+    if(psReader->uiPos >= psReader->uiSize)
+    {
+        return ucDefault;
+    }
+    
+    return psReader->pucData[psReader->uiPos++];
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads the next two bytes of the image. The low byte is first.
+\return     u16 - The read value or the default value when the image ends
+\param      psReader - The reader of the image
+\param      uiDefault - Value which is returned behind the end of the image
+***********************************************************************************/
+static u16 ReadWord(tsImageReader* psReader, u16 uiDefault)
+{
+    if(psReader->uiPos + 2 > psReader->uiSize)
+    {
+        psReader->uiPos = psReader->uiSize;
+        return uiDefault;
+    }
+    
+    const u8 ucLow = ReadByte(psReader, 0);
+    const u8 ucHigh = ReadByte(psReader, 0);
+    
+    return (u16)(ucLow | (ucHigh << 8));
+}
+
+/****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Sets the persistent fields to their default values. The run-time
+            fields aren't changed.
+\return     none
+\param      psValues - The values which shall be set
+***********************************************************************************/
+void Aom_SettingsFormat_SetDefaults(tRegulationValues* psValues)
+{
+    u8 ucIdx;
+    for(ucIdx = 0; ucIdx < DRIVE_OUTPUTS; ucIdx++)
+    {
+        psValues->sLedValue[ucIdx].ucPercentValue = 0;
+        psValues->sLedValue[ucIdx].bStatus = OFF;
+    }
+    
+    memset(psValues->sUserTimerSettings.sTimer, 0, sizeof(psValues->sUserTimerSettings.sTimer));
+    psValues->sUserTimerSettings.sTimer[0] = sDefaultTimer;
+    psValues->sUserTimerSettings.ucSetTimerBinary = 0x01 << 0;
+    psValues->sUserTimerSettings.ucBurningTime = 0;
+    psValues->sUserTimerSettings.bAutomaticModeActive = false;
+    psValues->sUserTimerSettings.bMotionDetectOnOff = false;
+    psValues->bNightModeOnOff = false;
+    
+    psValues->sSunTimer.siLatitude = SUN_DEFAULT_LATITUDE;
+    psValues->sSunTimer.siLongitude = SUN_DEFAULT_LONGITUDE;
+    psValues->sSunTimer.scDuskOffset = 0;
+    psValues->sSunTimer.scDawnOffset = 0;
+    psValues->sSunTimer.bSunTimerActive = false;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Packs the persistent fields into an image of the current format.
+\return     none
+\param      psValues - The values which shall be packed
+\param      pucImage - The image of USER_SETTINGS_PACKED_SIZE bytes
+***********************************************************************************/
+void Aom_SettingsFormat_Pack(const tRegulationValues* psValues, u8* pucImage)
+{
+    u16 uiPos = 0;
+    
+    pucImage[uiPos++] = USER_SETTINGS_FORMAT_MAGIC;
+    pucImage[uiPos++] = USER_SETTINGS_FORMAT_VERSION;
+    pucImage[uiPos++] = DRIVE_OUTPUTS;
+    pucImage[uiPos++] = USER_TIMER_AMOUNT;
+    
+    u8 ucIdx;
+    for(ucIdx = 0; ucIdx < DRIVE_OUTPUTS; ucIdx++)
+    {
+        pucImage[uiPos++] = psValues->sLedValue[ucIdx].ucPercentValue;
+        pucImage[uiPos++] = psValues->sLedValue[ucIdx].bStatus;
+    }
+    
+    for(ucIdx = 0; ucIdx < USER_TIMER_AMOUNT; ucIdx++)
+    {
+        const tsTimeFormat* psTimer = &psValues->sUserTimerSettings.sTimer[ucIdx];
+        
+        pucImage[uiPos++] = psTimer->ucHourSet;
+        pucImage[uiPos++] = psTimer->ucMinSet;
+        pucImage[uiPos++] = psTimer->ucHourClear;
+        pucImage[uiPos++] = psTimer->ucMinClear;
+    }
+    
+    pucImage[uiPos++] = psValues->sUserTimerSettings.ucSetTimerBinary;
+    pucImage[uiPos++] = psValues->sUserTimerSettings.ucBurningTime;
+    pucImage[uiPos++] = psValues->sUserTimerSettings.bAutomaticModeActive;
+    pucImage[uiPos++] = psValues->sUserTimerSettings.bMotionDetectOnOff;
+    pucImage[uiPos++] = psValues->bNightModeOnOff;
+    
+    const tsSunTimerSettings* psSunTimer = &psValues->sSunTimer;
+    
+    pucImage[uiPos++] = (u8)psSunTimer->siLatitude;
+    pucImage[uiPos++] = (u8)(psSunTimer->siLatitude >> 8);
+    pucImage[uiPos++] = (u8)psSunTimer->siLongitude;
+    pucImage[uiPos++] = (u8)(psSunTimer->siLongitude >> 8);
+    pucImage[uiPos++] = (u8)psSunTimer->scDuskOffset;
+    pucImage[uiPos++] = (u8)psSunTimer->scDawnOffset;
+    pucImage[uiPos++] = psSunTimer->bSunTimerActive;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Unpacks an image of the current or an older format version with one
+            pass. The persistent fields are set to their defaults first.
+\return     bool - False when the image is invalid or has a newer version. The
+                   values are set to the defaults in this case.
+\param      pucImage - The packed image
+\param      uiSize - Size of the image in bytes
+\param      psValues - The values which shall be filled
+***********************************************************************************/
+bool Aom_SettingsFormat_Unpack(const u8* pucImage, u16 uiSize, tRegulationValues* psValues)
+{
+    tsImageReader sReader = {pucImage, uiSize, 0};
+    
+    Aom_SettingsFormat_SetDefaults(psValues);
+    
+    const u8 ucMagic = ReadByte(&sReader, 0);
+    const u8 ucVersion = ReadByte(&sReader, 0);
+    const u8 ucOutputs = ReadByte(&sReader, 0);
+    const u8 ucTimers = ReadByte(&sReader, 0);
+    
+    if(ucMagic != USER_SETTINGS_FORMAT_MAGIC || ucVersion == 0 || ucVersion > USER_SETTINGS_FORMAT_VERSION)
+    {
+        return false;
+    }
+    
+    u8 ucIdx;
+    for(ucIdx = 0; ucIdx < ucOutputs; ucIdx++)
+    {
+        const u8 ucPercentValue = ReadByte(&sReader, 0);
+        const u8 ucStatus = ReadByte(&sReader, 0);
+        
+        if(ucIdx < DRIVE_OUTPUTS)
+        {
+            psValues->sLedValue[ucIdx].ucPercentValue = ucPercentValue;
+            psValues->sLedValue[ucIdx].bStatus = (ucStatus != 0);
+        }
+    }
+    
+    for(ucIdx = 0; ucIdx < ucTimers; ucIdx++)
+    {
+        tsTimeFormat sTimer;
+        sTimer.ucHourSet = ReadByte(&sReader, 0);
+        sTimer.ucMinSet = ReadByte(&sReader, 0);
+        sTimer.ucHourClear = ReadByte(&sReader, 0);
+        sTimer.ucMinClear = ReadByte(&sReader, 0);
+        
+        if(ucIdx < USER_TIMER_AMOUNT)
+        {
+            psValues->sUserTimerSettings.sTimer[ucIdx] = sTimer;
+        }
+    }
+    
+    tsUserTimeSettings* psTimerSettings = &psValues->sUserTimerSettings;
+    
+    psTimerSettings->ucSetTimerBinary = ReadByte(&sReader, psTimerSettings->ucSetTimerBinary);
+    psTimerSettings->ucBurningTime = ReadByte(&sReader, psTimerSettings->ucBurningTime);
+    psTimerSettings->bAutomaticModeActive = (ReadByte(&sReader, psTimerSettings->bAutomaticModeActive) != 0);
+    psTimerSettings->bMotionDetectOnOff = (ReadByte(&sReader, psTimerSettings->bMotionDetectOnOff) != 0);
+    psValues->bNightModeOnOff = (ReadByte(&sReader, psValues->bNightModeOnOff) != 0);
+    
+    /* The sun timer was added with version 2. Version 1 images keep its defaults */
+    if(ucVersion >= 2)
+    {
+        tsSunTimerSettings* psSunTimer = &psValues->sSunTimer;
+        
+        psSunTimer->siLatitude = (s16)ReadWord(&sReader, (u16)psSunTimer->siLatitude);
+        psSunTimer->siLongitude = (s16)ReadWord(&sReader, (u16)psSunTimer->siLongitude);
+        psSunTimer->scDuskOffset = (s8)ReadByte(&sReader, (u8)psSunTimer->scDuskOffset);
+        psSunTimer->scDawnOffset = (s8)ReadByte(&sReader, (u8)psSunTimer->scDawnOffset);
+        psSunTimer->bSunTimerActive = (ReadByte(&sReader, psSunTimer->bSunTimerActive) != 0);
+    }
+    
+    /* Timers which don't exist anymore can't be active */
+    if(USER_TIMER_AMOUNT < 8)
+    {
+        psTimerSettings->ucSetTimerBinary &= (0x01 << USER_TIMER_AMOUNT) - 1;
+    }
+    
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Takes over the persistent fields of a raw settings image of the OS
+            flash area. This was the storage format before the packed image.
+            Fields which the raw image doesn't have keep their default values.
+\return     none
+\param      psLegacy - The raw image
+\param      psValues - The values which shall be filled
+***********************************************************************************/
+void Aom_SettingsFormat_MigrateLegacy(const tRegulationValues* psLegacy, tRegulationValues* psValues)
+{
+    /* The sun timer settings are newer than the raw image */
+    Aom_SettingsFormat_SetDefaults(psValues);
+    
+    u8 ucIdx;
+    for(ucIdx = 0; ucIdx < DRIVE_OUTPUTS; ucIdx++)
+    {
+        psValues->sLedValue[ucIdx].ucPercentValue = psLegacy->sLedValue[ucIdx].ucPercentValue;
+        psValues->sLedValue[ucIdx].bStatus = psLegacy->sLedValue[ucIdx].bStatus;
+    }
+    
+    memcpy(&psValues->sUserTimerSettings, &psLegacy->sUserTimerSettings, sizeof(tsUserTimeSettings));
+    psValues->bNightModeOnOff = psLegacy->bNightModeOnOff;
+}
@@ -0,0 +1,46 @@
+/* ========================================
+ *
+ * Copyright Eduard Kraemer, 2026
+ *
+ * ========================================
+*/
+
+#ifndef _AOM_SETTINGSFORMAT_H_
+#define _AOM_SETTINGSFORMAT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif   
+
+#include "BaseTypes.h"
+#include "Aom.h"
+
+#define USER_SETTINGS_FORMAT_MAGIC      0xA5    //First byte of a packed image
+#define USER_SETTINGS_FORMAT_VERSION    2       //Increment when a field is added or changes its meaning
+
+/* Layout of the packed image: header, outputs, timers, the common fields and the sun timer (version 2).
+   The fields are single bytes except the latitude and longitude of the sun timer. These 16 bit values
+   are stored low byte first */
+#define USER_SETTINGS_HEADER_SIZE       4       //Magic, version, output count, timer count
+#define USER_SETTINGS_OUTPUT_SIZE       2       //Percent value and status
+#define USER_SETTINGS_TIMER_SIZE        4       //Set and clear time
+#define USER_SETTINGS_COMMON_SIZE       5       //Timer mask, burning time, automatic mode, motion detection, night mode
+#define USER_SETTINGS_SUN_SIZE          7       //Latitude, longitude, dusk and dawn offset, sun timer active
+
+#define USER_SETTINGS_PACKED_SIZE       (USER_SETTINGS_HEADER_SIZE                          \
+                                         + (DRIVE_OUTPUTS * USER_SETTINGS_OUTPUT_SIZE)      \
+                                         + (USER_TIMER_AMOUNT * USER_SETTINGS_TIMER_SIZE)   \
+                                         + USER_SETTINGS_COMMON_SIZE                        \
+                                         + USER_SETTINGS_SUN_SIZE)
+
+void Aom_SettingsFormat_SetDefaults(tRegulationValues* psValues);
+void Aom_SettingsFormat_Pack(const tRegulationValues* psValues, u8* pucImage);
+bool Aom_SettingsFormat_Unpack(const u8* pucImage, u16 uiSize, tRegulationValues* psValues);
+void Aom_SettingsFormat_MigrateLegacy(const tRegulationValues* psLegacy, tRegulationValues* psValues);
+
+#ifdef __cplusplus
+}
+#endif    
+
+#endif //_AOM_SETTINGSFORMAT_H_
@@ -4,13 +4,82 @@
  *
  * ========================================
 */
+#include <project.h>
+
 #include "Aom_Time.h"
 #include "OS_EventManager.h"
+#include "EventQueue.h"
+#include "SunTime.h"
 
 /****************************************** Defines ******************************************************/
+#define SCHEDULE_WORDS      ((MINUTES_PER_DAY + 31) / 32)
+#define SECONDS_PER_DAY     86400
+#define EPOCH_WEEKDAY       3       //01.01.1970 was a Thursday
+
 /****************************************** Variables ****************************************************/
+/* One bit for each minute of the day. A set bit is within an active user timer slot */
+static u32 ulUserTimerSchedule[SCHEDULE_WORDS];
+
 /****************************************** Function prototypes ******************************************/
+static void SetScheduleRange(u16 uiStartMin, u16 uiEndMin);
+static void AddScheduleSlot(u16 uiSetMin, u16 uiClearMin);
+
 /****************************************** loacl functiones *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Sets the bits of the minutes from the start until the end minute
+            (excluded) in the schedule.
+\return     none
+\param      uiStartMin - First minute of the day
+\param      uiEndMin - Minute behind the last one. At most MINUTES_PER_DAY
+***********************************************************************************/
+static void SetScheduleRange(u16 uiStartMin, u16 uiEndMin)
+{
+    u16 uiMin = uiStartMin;
+    
+    while(uiMin < uiEndMin)
+    {
+        /* Set whole words when possible */
+        if((uiMin % 32) == 0 && (uiEndMin - uiMin) >= 32)
+        {
+            ulUserTimerSchedule[uiMin / 32] = 0xFFFFFFFF;
+            uiMin += 32;
+        }
+        else
+        {
+            ulUserTimerSchedule[uiMin / 32] |= 0x01UL << (uiMin % 32);
+            uiMin++;
+        }
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Adds a slot to the schedule. A clear time before the set time
+            continues the slot over midnight.
+\return     none
+\param      uiSetMin - Minute of the day where the slot starts
+\param      uiClearMin - Minute of the day where the slot ends
+***********************************************************************************/
+static void AddScheduleSlot(u16 uiSetMin, u16 uiClearMin)
+{
+    if(uiSetMin < uiClearMin)
+    {
+        SetScheduleRange(uiSetMin, uiClearMin);
+    }
+    else if(uiSetMin > uiClearMin)
+    {
+        /* Slot over midnight */
+        SetScheduleRange(uiSetMin, MINUTES_PER_DAY);
+        SetScheduleRange(0, uiClearMin);
+    }
+}
+
 /****************************************** External visible functiones **********************************/
 //********************************************************************************
 /*!
@@ -28,7 +97,7 @@ void Aom_Time_SetReceivedTime(u8 ucHour, u8 ucMin, u32 ulTicks)
     psCurrentTime->ucMinutes = ucMin;
     psCurrentTime->ulTicks = ulTicks;
     
-    OS_EVT_PostEvent(eEvtTimeReceived, eEvtParam_TimeFromNtpClient ,0);
+    EventQueue_PostToOs(eEvtTimeReceived, eEvtParam_TimeFromNtpClient ,0);
 }
 
 //********************************************************************************
@@ -48,7 +117,63 @@ void Aom_Time_SetRealTimeClockTime(u8 ucHour, u8 ucMin, u32 ulTicks)
     psCurrentTime->ucMinutes = ucMin;
     psCurrentTime->ulTicks = ulTicks;
     
-    OS_EVT_PostEvent(eEvtTimeReceived, eEvtParam_TimeFromRtc, 0);
+    EventQueue_PostToOs(eEvtTimeReceived, eEvtParam_TimeFromRtc, 0);
+}
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the offset of the local time to UTC. The epoch time is
+            in UTC and the hours and minutes are the local time. A difference
+            of more than half a day is on the next or previous day.
+\return     s16 - Offset in minutes which is added to UTC
+\param      none
+***********************************************************************************/
+s16 Aom_Time_GetUtcOffsetMin(void)
+{
+    const tsCurrentTime* psTime = Aom_GetCurrentTimePointer();
+    
+    s16 siOffsetMin = ((psTime->ucHours * 60) + psTime->ucMinutes) - ((psTime->ulTicks % SECONDS_PER_DAY) / 60);
+    
+    if(siOffsetMin > (MINUTES_PER_DAY / 2))
+    {
+        siOffsetMin -= MINUTES_PER_DAY;
+    }
+    else if(siOffsetMin < -(MINUTES_PER_DAY / 2))
+    {
+        siOffsetMin += MINUTES_PER_DAY;
+    }
+    
+    return siOffsetMin;
+}
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the local day since 01.01.1970.
+\return     u32 - The local day
+\param      none
+***********************************************************************************/
+u32 Aom_Time_GetLocalDay(void)
+{
+    const tsCurrentTime* psTime = Aom_GetCurrentTimePointer();
+    
+    return (u32)(psTime->ulTicks + (Aom_Time_GetUtcOffsetMin() * 60)) / SECONDS_PER_DAY;
+}
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the day of the week from the local day.
+\return     u8 - Day of the week. 0 = Monday .. 6 = Sunday
+\param      none
+***********************************************************************************/
+u8 Aom_Time_GetWeekday(void)
+{
+    return (u8)((Aom_Time_GetLocalDay() + EPOCH_WEEKDAY) % 7);
 }
 
 //********************************************************************************
@@ -110,8 +235,186 @@ void Aom_Time_SetUserTimerSettings(tsTimeFormat* psUserTimerSettings, u8 ucTimer
     {
         psRegulationValues->sUserTimerSettings.ucSetTimerBinary |= 0x01 << ucTimerIdx;
         
+        Aom_Time_CompileUserTimerSchedule();
+        
         /* Start with event */
-        OS_EVT_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, 0);
+        EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, 0, eEvtPost_Unique);
     }    
 }
 
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Saves the location and the offsets of the sun timer. The sun times
+            are calculated again for the new location.
+\return     bool - False when the location is out of range
+\param      psSunTimerSettings - The new sun timer settings
+***********************************************************************************/
+bool Aom_Time_SetSunTimerSettings(const tsSunTimerSettings* psSunTimerSettings)
+{
+    if(psSunTimerSettings == NULL
+        || psSunTimerSettings->siLatitude > 9000 || psSunTimerSettings->siLatitude < -9000
+        || psSunTimerSettings->siLongitude > 18000 || psSunTimerSettings->siLongitude < -18000)
+    {
+        return false;
+    }
+    
+    Aom_GetRegulationSettings()->sSunTimer = *psSunTimerSettings;
+    
+    SunTime_Update();
+    Aom_Time_CompileUserTimerSchedule();
+    
+    /* Start with event */
+    EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, 0, eEvtPost_Unique);
+    
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Compiles the active user timers into the minute of day schedule.
+            A slot starts with the set time and ends before the clear time. A
+            clear time before the set time continues the slot over midnight.
+            The active sun timer adds the slot from dusk until dawn.
+            Has to be called after the timer settings were changed.
+\return     none
+\param      none
+***********************************************************************************/
+void Aom_Time_CompileUserTimerSchedule(void)
+{
+    const tsUserTimeSettings* psTimerSettings = &Aom_GetRegulationSettings()->sUserTimerSettings;
+    
+    memset(ulUserTimerSchedule, 0, sizeof(ulUserTimerSchedule));
+    
+    u8 ucTimerIdx;
+    for(ucTimerIdx = 0; ucTimerIdx < USER_TIMER_AMOUNT; ucTimerIdx++)
+    {
+        const tsTimeFormat* psTimer = &psTimerSettings->sTimer[ucTimerIdx];
+        
+        if((psTimerSettings->ucSetTimerBinary & (0x01 << ucTimerIdx)) == 0
+            || psTimer->ucHourSet >= 24 || psTimer->ucMinSet >= 60
+            || psTimer->ucHourClear >= 24 || psTimer->ucMinClear >= 60)
+        {
+            continue;
+        }
+        
+        AddScheduleSlot((psTimer->ucHourSet * 60) + psTimer->ucMinSet, (psTimer->ucHourClear * 60) + psTimer->ucMinClear);
+    }
+    
+    /* The sun timer is a virtual slot from dusk until dawn */
+    u16 uiDusk;
+    u16 uiDawn;
+    
+    if(Aom_Time_GetDuskToDawn(&uiDusk, &uiDawn))
+    {
+        AddScheduleSlot(uiDusk, uiDawn);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       19.10.2026
+\brief      Returns the dusk and the dawn of the local day with the offsets of
+            the sun timer settings.
+\return     bool - False when the sun timer isn't active or there are no sun
+                   times (No time or location known, polar day or night)
+\param      puiDusk - Local minute of the day of the dusk
+\param      puiDawn - Local minute of the day of the dawn
+***********************************************************************************/
+bool Aom_Time_GetDuskToDawn(u16* puiDusk, u16* puiDawn)
+{
+    const tsSunTimerSettings* psSunTimer = &Aom_GetRegulationSettings()->sSunTimer;
+    u16 uiSunrise;
+    u16 uiSunset;
+    
+    if(psSunTimer->bSunTimerActive == false || SunTime_GetTimes(&uiSunrise, &uiSunset) == false)
+    {
+        return false;
+    }
+    
+    *puiDusk = (uiSunset + MINUTES_PER_DAY + psSunTimer->scDuskOffset) % MINUTES_PER_DAY;
+    *puiDawn = (uiSunrise + MINUTES_PER_DAY + psSunTimer->scDawnOffset) % MINUTES_PER_DAY;
+    
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Checks if the time is within an active user timer slot.
+\return     bool - True when in a time slot
+\param      ucHours - The hour of the time
+\param      ucMin - The minutes of the time
+***********************************************************************************/
+bool Aom_Time_IsInUserTimerSlot(u8 ucHours, u8 ucMin)
+{
+    const u16 uiMinOfDay = (ucHours * 60) + ucMin;
+    
+    if(uiMinOfDay >= MINUTES_PER_DAY)
+    {
+        return false;
+    }
+    
+    return ((ulUserTimerSchedule[uiMinOfDay / 32] >> (uiMinOfDay % 32)) & 0x01);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Searches the schedule for the next minute where a user timer slot
+            starts or ends. The search compares whole words against the state
+            of the current minute and continues over midnight.
+\return     u16 - Minutes until the next edge. 0 when the schedule has no edge
+\param      ucHours - The hour of the time
+\param      ucMin - The minutes of the time
+***********************************************************************************/
+u16 Aom_Time_GetMinutesToNextScheduleEdge(u8 ucHours, u8 ucMin)
+{
+    const u16 uiMinOfDay = (ucHours * 60) + ucMin;
+    
+    if(uiMinOfDay >= MINUTES_PER_DAY)
+    {
+        return 0;
+    }
+    
+    /* Bits which differ from this fill value are an edge */
+    const u32 ulFill = Aom_Time_IsInUserTimerSlot(ucHours, ucMin) ? 0xFFFFFFFF : 0;
+    
+    u16 uiMin = (uiMinOfDay + 1) % MINUTES_PER_DAY;
+    u16 uiDistance = 1;
+    
+    while(uiDistance < MINUTES_PER_DAY)
+    {
+        const u8 ucBitIdx = uiMin % 32;
+        u32 ulDiff = (ulUserTimerSchedule[uiMin / 32] ^ ulFill) >> ucBitIdx;
+        
+        if(ulDiff)
+        {
+            /* Count the minutes until the first differing bit */
+            while((ulDiff & 0x01) == 0)
+            {
+                ulDiff >>= 1;
+                uiDistance++;
+            }
+            
+            return (uiDistance < MINUTES_PER_DAY) ? uiDistance : 0;
+        }
+        
+        /* No edge in the rest of this word */
+        uiDistance += 32 - ucBitIdx;
+        uiMin = (uiMin + 32 - ucBitIdx) % MINUTES_PER_DAY;
+    }
+    
+    return 0;
+}
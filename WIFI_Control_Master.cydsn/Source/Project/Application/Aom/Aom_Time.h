@@ -21,11 +21,21 @@ extern "C"
 #include "BaseTypes.h"
 #include "Aom.h"
 
+#define MINUTES_PER_DAY     1440
+
 const tsCurrentTime* Aom_Time_GetCurrentTime(void);
+s16 Aom_Time_GetUtcOffsetMin(void);
+u32 Aom_Time_GetLocalDay(void);
+u8 Aom_Time_GetWeekday(void);
 
 void Aom_Time_SetReceivedTime(u8 ucHour, u8 ucMin, u32 ulTicks);
 void Aom_Time_SetRealTimeClockTime(u8 ucHour, u8 ucMin, u32 ulTicks);
 void Aom_Time_SetUserTimerSettings(tsTimeFormat* psUserTimerSettings, u8 ucTimerIdx);
+bool Aom_Time_SetSunTimerSettings(const tsSunTimerSettings* psSunTimerSettings);
+void Aom_Time_CompileUserTimerSchedule(void);
+bool Aom_Time_GetDuskToDawn(u16* puiDusk, u16* puiDawn);
+bool Aom_Time_IsInUserTimerSlot(u8 ucHours, u8 ucMin);
+u16 Aom_Time_GetMinutesToNextScheduleEdge(u8 ucHours, u8 ucMin);
 
 #ifdef __cplusplus
 }
@@ -15,12 +15,14 @@
 #include "OS_Communication.h"
 
 #include "RequestResponseHandler.h"
+#include "UserMessageHandler.h"
 
 #include "Aom_Regulation.h"
 #include "Aom_System.h"
 #include "Aom_Time.h"
 #include "Aom_Measure.h"
 #include "Aom_Flash.h"
+#include "EventQueue.h"
 
 /****************************************** Defines ******************************************************/
 
@@ -349,7 +351,7 @@ teMessageType ReqResMsg_Handler(tsMessageFrame* psMsgFrame)
             if(eCommand == eCmdSet)
             {
                 /* Post init event */
-                OS_EVT_PostEvent(eEvtInitRegulationValue, eEvtParam_InitRegulationStart, 0);
+                EventQueue_PostToOs(eEvtInitRegulationValue, eEvtParam_InitRegulationStart, 0);
             }
             else
             {
@@ -438,7 +440,7 @@ teMessageType ReqResMsg_Handler(tsMessageFrame* psMsgFrame)
             if(eCommand == eCmdSet)
             {                
                 /* Generate a wake-up-event */
-                OS_EVT_PostEvent(eEvtStandby_WakeUpReceived, 0, 0);
+                EventQueue_PostToOs(eEvtStandby_WakeUpReceived, 0, 0);
             }
             break;
         }
@@ -504,7 +506,8 @@ teMessageType ReqResMsg_Handler(tsMessageFrame* psMsgFrame)
         }
         
         default:
-            eResponse = eTypeDenied;
+            /* Check for the project specific messages */
+            eResponse = UserMsg_Handler(psMsgFrame);
             break;
     }
     return eResponse;
@@ -13,6 +13,7 @@
 #include "OS_ErrorDebouncer.h"
 #include "OS_Communication.h"
 #include "ResponseDeniedHandler.h"
+#include "EventQueue.h"
 
 //#include "Version\Version.h"
 /****************************************** Defines ******************************************************/
@@ -48,7 +49,7 @@ teMessageType ResDeniedMsg_Handler(tsMessageFrame* psMsgFrame)
         /* When sleep request is denied, stop the further handling of the sleep */
         case eMsgSleep:
         {
-            OS_EVT_PostEvent(eEvtStandby, eEvtParam_ExitStandby, 0);
+            EventQueue_PostToOs(eEvtStandby, eEvtParam_ExitStandby, 0);
             eResponse = eTypeAck;
             break;
         }
@@ -0,0 +1,757 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       UserMessageHandler.c
+\brief      Handler for the project specific messages. Is called for the
+            requests and responses which aren't known by the OS messages.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "BaseTypes.h"
+#include "OS_Communication.h"
+
+#include "UserMessages.h"
+#include "UserMessageHandler.h"
+
+#include "EventQueue.h"
+#include "DR_System.h"
+#include "DR_Regulation.h"
+#include "FlightRecorder.h"
+#include "SelfTestScheduler.h"
+#include "Profiler.h"
+#include "Aom_Flash.h"
+#include "Aom_Journal.h"
+#include "FaultLog.h"
+#include "TimerTable.h"
+#include "Aom_Time.h"
+#include "SunTime.h"
+#include "Scene.h"
+#include "Occupancy.h"
+
+/****************************************** Defines ******************************************************/
+
+/****************************************** Function prototypes ******************************************/
+static u16 SaturateU16(u32 ulValue);
+static void SendEventStatistic(u8 ucPage);
+static void SendFlightRecorder(u8 ucPage, bool bPreviousBoot);
+static void SendFlashStatistic(void);
+static void SendFaultLog(u8 ucPage);
+static void SendTimerTableChunk(u8 ucChunk);
+static bool ReceiveTimerTableChunk(const tMsgTimerTableChunk* psChunk);
+static void SendSunTimer(void);
+static bool ReceiveSunTimer(const tMsgSunTimer* psMsgSunTimer);
+static void SendScene(u8 ucSceneIdx);
+static bool ReceiveScene(const tMsgScene* psMsgScene);
+static void SendMetering(u8 ucPage);
+#if PROFILER_ENABLE
+static void SendProfileEntry(u8 ucProfileId);
+#endif
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Limits the value to the range of an u16
+\return     u16 - The limited value
+\param      ulValue - The value which shall be limited
+***********************************************************************************/
+static u16 SaturateU16(u32 ulValue)
+{
+    return (ulValue > 0xFFFF) ? 0xFFFF : (u16)ulValue;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends the requested page of the event loop statistic
+\return     none
+\param      ucPage - The requested page. See EVT_STAT_PAGE_...
+***********************************************************************************/
+static void SendEventStatistic(u8 ucPage)
+{
+    if(ucPage == EVT_STAT_PAGE_OVERVIEW)
+    {
+        tMsgEventStatisticOverview sMsgOverview;
+        memset(&sMsgOverview, 0, sizeof(sMsgOverview));
+        
+        const tsEventPostStatistic* psPostStatistic = EventQueue_GetPostStatistic();
+        sMsgOverview.uiPosted = SaturateU16(psPostStatistic->ulPosted);
+        sMsgOverview.uiCoalesced = SaturateU16(psPostStatistic->ulDiscarded + psPostStatistic->ulMerged);
+        sMsgOverview.uiDeferred = SaturateU16(psPostStatistic->ulDeferred);
+        
+        u8 ucLaneIdx;
+        for(ucLaneIdx = 0; ucLaneIdx < eEvtLane_Max; ucLaneIdx++)
+        {
+            const tsEventLaneStatistic* psLaneStatistic = EventQueue_GetLaneStatistic((teEventLane)ucLaneIdx);
+            
+            sMsgOverview.auiOverflow[ucLaneIdx] = SaturateU16(psLaneStatistic->ulOverflowCnt);
+            sMsgOverview.auiMaxWaitUs[ucLaneIdx] = psLaneStatistic->uiMaxWaitUs;
+            sMsgOverview.aucHighWater[ucLaneIdx] = psLaneStatistic->ucHighWater;
+            
+            if(psLaneStatistic->ulEventCnt)
+            {
+                sMsgOverview.auiAvgWaitUs[ucLaneIdx] = SaturateU16(psLaneStatistic->ulSumWaitUs / psLaneStatistic->ulEventCnt);
+            }
+        }
+        
+        sMsgOverview.ucPage = ucPage;
+        sMsgOverview.ucPageCount = EVT_STAT_PAGE_COUNT;
+        
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgEventStatistic, &sMsgOverview, sizeof(tMsgEventStatisticOverview), eNoCmd);
+    }
+    else if(ucPage == EVT_STAT_PAGE_SYSTEM)
+    {
+        tMsgSystemStatistic sMsgSystem;
+        memset(&sMsgSystem, 0, sizeof(sMsgSystem));
+        
+        #if (WITHOUT_REGULATION == false)
+            const tsWakeLatency* psWakeLatency = DR_Regulation_GetWakeLatency();
+            sMsgSystem.uiLightOnUs = psWakeLatency->uiLightOnUs;
+            sMsgSystem.uiLightOnMaxUs = psWakeLatency->uiLightOnMaxUs;
+            sMsgSystem.uiActiveReachedMs = psWakeLatency->uiActiveReachedMs;
+            sMsgSystem.uiActiveReachedMaxMs = psWakeLatency->uiActiveReachedMaxMs;
+            sMsgSystem.uiFastWakeCount = psWakeLatency->uiFastWakeCount;
+        #endif
+        
+        const tsSelfTestStatistic* psSelfTest = SelfTestScheduler_GetStatistic();
+        sMsgSystem.uiSelfTestPeriodMs = psSelfTest->uiCoveragePeriodMs;
+        sMsgSystem.uiSelfTestPeriodMaxMs = psSelfTest->uiCoveragePeriodMaxMs;
+        
+        u8 ucStepIdx;
+        for(ucStepIdx = 0; ucStepIdx < SELFTEST_C_STEPS; ucStepIdx++)
+        {
+            if(psSelfTest->auiStepMaxUs[ucStepIdx] > sMsgSystem.uiSelfTestStepMaxUs)
+            {
+                sMsgSystem.uiSelfTestStepMaxUs = psSelfTest->auiStepMaxUs[ucStepIdx];
+            }
+        }
+        
+        sMsgSystem.ucIdlePercent = DR_System_GetIdlePercent();
+        sMsgSystem.ucPage = ucPage;
+        
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgEventStatistic, &sMsgSystem, sizeof(tMsgSystemStatistic), eNoCmd);
+    }
+    else if(ucPage < EVT_STAT_PAGE_COUNT)
+    {
+        tMsgEventHistogram sMsgHistogram;
+        memset(&sMsgHistogram, 0, sizeof(sMsgHistogram));
+        
+        sMsgHistogram.ucEventId = (ucPage - EVT_STAT_PAGE_HISTOGRAM) / 2;
+        sMsgHistogram.ucExecTime = (ucPage - EVT_STAT_PAGE_HISTOGRAM) % 2;
+        
+        const tsEventHistogram* psHistogram = EventQueue_GetHistogram(sMsgHistogram.ucEventId);
+        const u16* puiBuckets = sMsgHistogram.ucExecTime ? psHistogram->auiExecUs : psHistogram->auiWaitUs;
+        memcpy(sMsgHistogram.auiBuckets, puiBuckets, sizeof(sMsgHistogram.auiBuckets));
+        
+        sMsgHistogram.ucPage = ucPage;
+        sMsgHistogram.ucPageCount = EVT_STAT_PAGE_COUNT;
+        
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgEventStatistic, &sMsgHistogram, sizeof(tMsgEventHistogram), eNoCmd);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends the requested page of the flight recorder
+\return     none
+\param      ucPage - The requested page. Zero is the summary
+\param      bPreviousBoot - True for the log before the last reset
+***********************************************************************************/
+static void SendFlightRecorder(u8 ucPage, bool bPreviousBoot)
+{
+    const u16 uiEntryCount = FlightRecorder_GetEntryCount(bPreviousBoot);
+    const u8 ucPageCount = 1 + (uiEntryCount + FLIGHT_REC_ENTRIES_PER_PAGE - 1) / FLIGHT_REC_ENTRIES_PER_PAGE;
+
+    if(ucPage == FLIGHT_REC_PAGE_SUMMARY)
+    {
+        tMsgFlightRecSummary sMsgSummary;
+        memset(&sMsgSummary, 0, sizeof(sMsgSummary));
+
+        sMsgSummary.ulResetReason = FlightRecorder_GetResetReason();
+        sMsgSummary.uiBootCount = FlightRecorder_GetBootCount();
+        sMsgSummary.uiEntryCount = uiEntryCount;
+        sMsgSummary.ucPage = ucPage;
+        sMsgSummary.ucPageCount = ucPageCount;
+        sMsgSummary.ucPreviousBoot = bPreviousBoot;
+
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgFlightRecorder, &sMsgSummary, sizeof(tMsgFlightRecSummary), eNoCmd);
+    }
+    else if(ucPage < ucPageCount)
+    {
+        tMsgFlightRecEntries sMsgEntries;
+        memset(&sMsgEntries, 0, sizeof(sMsgEntries));
+
+        const u16 uiFirstEntry = (ucPage - 1) * FLIGHT_REC_ENTRIES_PER_PAGE;
+
+        u8 ucEntryIdx;
+        for(ucEntryIdx = 0; ucEntryIdx < FLIGHT_REC_ENTRIES_PER_PAGE; ucEntryIdx++)
+        {
+            if(FlightRecorder_GetEntry(bPreviousBoot, uiFirstEntry + ucEntryIdx, &sMsgEntries.asEntries[ucEntryIdx]))
+            {
+                sMsgEntries.ucEntryCount++;
+            }
+        }
+
+        sMsgEntries.ucPage = ucPage;
+        sMsgEntries.ucPageCount = ucPageCount;
+        sMsgEntries.ucPreviousBoot = bPreviousBoot;
+
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgFlightRecorder, &sMsgEntries, sizeof(tMsgFlightRecEntries), eNoCmd);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends the write statistic of the settings in the flash
+\return     none
+\param      none
+***********************************************************************************/
+static void SendFlashStatistic(void)
+{
+    const tsFlashStatistic* psFlashStatistic = Aom_Flash_GetStatistic();
+    const tsJournalStatistic* psJournalStatistic = Aom_Journal_GetStatistic();
+    
+    tMsgFlashStatistic sMsgFlash;
+    memset(&sMsgFlash, 0, sizeof(sMsgFlash));
+    
+    sMsgFlash.ulProgrammedBytes = DR_Flash_GetProgrammedRows() * CY_FLASH_SIZEOF_ROW;
+    sMsgFlash.uiUserWrites = psFlashStatistic->uiUserWrites;
+    sMsgFlash.uiSystemWrites = psFlashStatistic->uiSystemWrites;
+    sMsgFlash.uiFailedWrites = psFlashStatistic->uiFailedWrites;
+    sMsgFlash.uiSkippedIdentical = psFlashStatistic->uiSkippedIdentical;
+    sMsgFlash.uiForcedWrites = psFlashStatistic->uiForcedWrites;
+    sMsgFlash.uiStandbyWrites = psFlashStatistic->uiStandbyWrites;
+    sMsgFlash.uiJournalCompactions = psJournalStatistic->uiCompactions;
+    sMsgFlash.uiJournalFreeRecords = psJournalStatistic->uiFreeRecords;
+    
+    u8 ucRowIdx;
+    for(ucRowIdx = 0; ucRowIdx < _countof(psJournalStatistic->auiRowWrites); ucRowIdx++)
+    {
+        if(psJournalStatistic->auiRowWrites[ucRowIdx] > sMsgFlash.uiJournalMaxRowWrites)
+        {
+            sMsgFlash.uiJournalMaxRowWrites = psJournalStatistic->auiRowWrites[ucRowIdx];
+        }
+    }
+    
+    OS_Communication_SendResponseMessage((teMessageId)eUserMsgFlashStatistic, &sMsgFlash, sizeof(tMsgFlashStatistic), eNoCmd);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends the requested page of the fault log
+\return     none
+\param      ucPage - The requested page. Zero is the summary
+***********************************************************************************/
+static void SendFaultLog(u8 ucPage)
+{
+    const u16 uiEntryCount = FaultLog_GetEntryCount();
+    const u8 ucPageCount = 1 + (uiEntryCount + FAULT_LOG_ENTRIES_PER_PAGE - 1) / FAULT_LOG_ENTRIES_PER_PAGE;
+
+    if(ucPage == FAULT_LOG_PAGE_SUMMARY)
+    {
+        tMsgFaultLogSummary sMsgSummary;
+        memset(&sMsgSummary, 0, sizeof(sMsgSummary));
+
+        sMsgSummary.uiEntryCount = uiEntryCount;
+        sMsgSummary.uiLostCount = FaultLog_GetLostCount();
+        sMsgSummary.ucPage = ucPage;
+        sMsgSummary.ucPageCount = ucPageCount;
+
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgFaultLog, &sMsgSummary, sizeof(tMsgFaultLogSummary), eNoCmd);
+    }
+    else if(ucPage < ucPageCount)
+    {
+        tMsgFaultLogEntries sMsgEntries;
+        memset(&sMsgEntries, 0, sizeof(sMsgEntries));
+
+        const u16 uiFirstEntry = (ucPage - 1) * FAULT_LOG_ENTRIES_PER_PAGE;
+
+        u8 ucEntryIdx;
+        for(ucEntryIdx = 0; ucEntryIdx < FAULT_LOG_ENTRIES_PER_PAGE; ucEntryIdx++)
+        {
+            if(FaultLog_GetEntry(uiFirstEntry + ucEntryIdx, &sMsgEntries.asEntries[ucEntryIdx]))
+            {
+                sMsgEntries.ucEntryCount++;
+            }
+        }
+
+        sMsgEntries.ucPage = ucPage;
+        sMsgEntries.ucPageCount = ucPageCount;
+
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgFaultLog, &sMsgEntries, sizeof(tMsgFaultLogEntries), eNoCmd);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends the requested chunk of the timer table
+\return     none
+\param      ucChunk - The requested chunk
+***********************************************************************************/
+static void SendTimerTableChunk(u8 ucChunk)
+{
+    const u8 ucEntryCount = TimerTable_GetEntryCount();
+
+    if(ucChunk == 0 || ucChunk < TIMER_TABLE_CHUNKS(ucEntryCount))
+    {
+        tMsgTimerTableChunk sMsgChunk;
+        memset(&sMsgChunk, 0, sizeof(sMsgChunk));
+
+        u8 ucEntryIdx;
+        for(ucEntryIdx = 0; ucEntryIdx < TIMER_TABLE_CHUNK_ENTRIES; ucEntryIdx++)
+        {
+            if(TimerTable_GetEntry((ucChunk * TIMER_TABLE_CHUNK_ENTRIES) + ucEntryIdx, &sMsgChunk.asEntries[ucEntryIdx]))
+            {
+                sMsgChunk.ucChunkEntries++;
+            }
+        }
+
+        sMsgChunk.ulTableCrc = TimerTable_GetCrc();
+        sMsgChunk.ucChunk = ucChunk;
+        sMsgChunk.ucEntryCount = ucEntryCount;
+
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgTimerTable, &sMsgChunk, sizeof(tMsgTimerTableChunk), eNoCmd);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Takes over a chunk of a new timer table. Chunk zero starts the
+            upload, the last chunk finishes it. A new table is evaluated with
+            the next regulation event.
+\return     bool - False when the chunk doesn't fit to the running upload
+\param      psChunk - The received chunk
+***********************************************************************************/
+static bool ReceiveTimerTableChunk(const tMsgTimerTableChunk* psChunk)
+{
+    if(psChunk->ucChunk == 0 && TimerTable_BeginUpload(psChunk->ucEntryCount) == false)
+    {
+        return false;
+    }
+
+    u8 ucEntryIdx;
+    for(ucEntryIdx = 0; ucEntryIdx < psChunk->ucChunkEntries && ucEntryIdx < TIMER_TABLE_CHUNK_ENTRIES; ucEntryIdx++)
+    {
+        if(TimerTable_UploadEntry((psChunk->ucChunk * TIMER_TABLE_CHUNK_ENTRIES) + ucEntryIdx, &psChunk->asEntries[ucEntryIdx]) == false)
+        {
+            return false;
+        }
+    }
+
+    /* Last chunk */
+    if(psChunk->ucChunk + 1 >= TIMER_TABLE_CHUNKS(psChunk->ucEntryCount))
+    {
+        if(TimerTable_EndUpload(psChunk->ulTableCrc) == false)
+        {
+            return false;
+        }
+
+        EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam_RegulationValueStartTimer, 0, eEvtPost_Unique);
+    }
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends the sun timer settings with the sunrise and sunset of today
+\return     none
+\param      none
+***********************************************************************************/
+static void SendSunTimer(void)
+{
+    const tsSunTimerSettings* psSunTimer = &Aom_GetRegulationSettings()->sSunTimer;
+
+    tMsgSunTimer sMsgSunTimer;
+    memset(&sMsgSunTimer, 0, sizeof(sMsgSunTimer));
+
+    sMsgSunTimer.siLatitude = psSunTimer->siLatitude;
+    sMsgSunTimer.siLongitude = psSunTimer->siLongitude;
+    sMsgSunTimer.scDuskOffset = psSunTimer->scDuskOffset;
+    sMsgSunTimer.scDawnOffset = psSunTimer->scDawnOffset;
+    sMsgSunTimer.ucActive = psSunTimer->bSunTimerActive;
+
+    SunTime_GetTimes(&sMsgSunTimer.uiSunrise, &sMsgSunTimer.uiSunset);
+
+    OS_Communication_SendResponseMessage((teMessageId)eUserMsgSunTimer, &sMsgSunTimer, sizeof(tMsgSunTimer), eNoCmd);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Saves the received sun timer settings. The sun times in the
+            message are ignored.
+\return     bool - False when the location is out of range
+\param      psMsgSunTimer - The received settings
+***********************************************************************************/
+static bool ReceiveSunTimer(const tMsgSunTimer* psMsgSunTimer)
+{
+    tsSunTimerSettings sSunTimer;
+
+    sSunTimer.siLatitude = psMsgSunTimer->siLatitude;
+    sSunTimer.siLongitude = psMsgSunTimer->siLongitude;
+    sSunTimer.scDuskOffset = psMsgSunTimer->scDuskOffset;
+    sSunTimer.scDawnOffset = psMsgSunTimer->scDawnOffset;
+    sSunTimer.bSunTimerActive = (psMsgSunTimer->ucActive != 0);
+
+    return Aom_Time_SetSunTimerSettings(&sSunTimer);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends a stored scene
+\return     none
+\param      ucSceneIdx - Index of the requested scene
+***********************************************************************************/
+static void SendScene(u8 ucSceneIdx)
+{
+    tMsgScene sMsgScene;
+    memset(&sMsgScene, 0, sizeof(sMsgScene));
+
+    if(Scene_Get(ucSceneIdx, &sMsgScene.sScene))
+    {
+        sMsgScene.ucScene = ucSceneIdx;
+
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgScene, &sMsgScene, sizeof(tMsgScene), eNoCmd);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Stores the received scene and recalls it, when requested. A recall
+            is answered only with the acknowledge.
+\return     bool - False when the scene or the action is invalid
+\param      psMsgScene - The received scene
+***********************************************************************************/
+static bool ReceiveScene(const tMsgScene* psMsgScene)
+{
+    if((psMsgScene->ucAction & (SCENE_ACTION_STORE | SCENE_ACTION_RECALL)) == 0)
+    {
+        return false;
+    }
+
+    if((psMsgScene->ucAction & SCENE_ACTION_STORE) && Scene_Store(psMsgScene->ucScene, &psMsgScene->sScene) == false)
+    {
+        return false;
+    }
+
+    if((psMsgScene->ucAction & SCENE_ACTION_RECALL) && Scene_Recall(psMsgScene->ucScene) == false)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends the saved on-time and energy of the adaptive burn time with
+            the burn times of the hours of the requested page
+\return     none
+\param      ucPage - The requested page
+***********************************************************************************/
+static void SendMetering(u8 ucPage)
+{
+    if(ucPage < METERING_PAGE_COUNT)
+    {
+        const u8 ucConfiguredBurnTime = Aom_GetRegulationSettings()->sUserTimerSettings.ucBurningTime;
+
+        tMsgMetering sMsgMetering;
+        memset(&sMsgMetering, 0, sizeof(sMsgMetering));
+
+        sMsgMetering.sStatistic = *Occupancy_GetStatistic();
+        sMsgMetering.ucPage = ucPage;
+        sMsgMetering.ucConfiguredBurnTime = ucConfiguredBurnTime;
+        sMsgMetering.ucAdaptive = Occupancy_GetAdaptiveStatus();
+
+        u8 ucHourIdx;
+        for(ucHourIdx = 0; ucHourIdx < METERING_HOURS_PER_PAGE; ucHourIdx++)
+        {
+            sMsgMetering.aucBurnTime[ucHourIdx] = Occupancy_GetBurnTime((ucPage * METERING_HOURS_PER_PAGE) + ucHourIdx, ucConfiguredBurnTime);
+        }
+
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgMetering, &sMsgMetering, sizeof(tMsgMetering), eNoCmd);
+    }
+}
+
+
+#if PROFILER_ENABLE
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\brief      Sends the execution times of the instrumented function
+\return     none
+\param      ucProfileId - The requested profile ID. See USER_PROFILE_LIST
+***********************************************************************************/
+static void SendProfileEntry(u8 ucProfileId)
+{
+    tsProfileEntry sEntry;
+    
+    if(Profiler_GetEntry((teProfileId)ucProfileId, &sEntry))
+    {
+        tMsgProfileEntry sMsgProfile;
+        memset(&sMsgProfile, 0, sizeof(sMsgProfile));
+        
+        sMsgProfile.ulCount = sEntry.ulCount;
+        sMsgProfile.uiMinUs = SaturateU16(DR_System_CyclesToUs(sEntry.ulMinCycles));
+        sMsgProfile.uiMaxUs = SaturateU16(DR_System_CyclesToUs(sEntry.ulMaxCycles));
+        
+        if(sEntry.ulCount)
+        {
+            sMsgProfile.uiAvgUs = SaturateU16(DR_System_CyclesToUs(sEntry.ulSumCycles / sEntry.ulCount));
+        }
+        
+        sMsgProfile.ucProfileId = ucProfileId;
+        sMsgProfile.ucProfileCount = eProfile_Max;
+        
+        OS_Communication_SendResponseMessage((teMessageId)eUserMsgProfiler, &sMsgProfile, sizeof(tMsgProfileEntry), eNoCmd);
+    }
+}
+#endif
+
+/****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     KraemerE    
+\date       18.10.2026  
+\brief      Handles the project specific messages.
+\return     eResponse - Acknowledge for known messages otherwise denied
+\param      psMsgFrame - Pointer to the message frame
+***********************************************************************************/
+teMessageType UserMsg_Handler(tsMessageFrame* psMsgFrame)
+{
+    /* Get payload */    
+    const teUserMessageId eMessageId = (teUserMessageId)OS_Communication_GetObject(psMsgFrame);
+    const teMessageCmd eCommand = OS_Communication_GetCommand(psMsgFrame);    
+   
+    teMessageType eResponse = eTypeAck;
+    
+    switch(eMessageId)
+    {
+        case eUserMsgEventStatistic:
+        {
+            if(eCommand == eCmdGet)
+            {
+                tMsgStatisticRequest* psRequest = (tMsgStatisticRequest*)psMsgFrame->sPayload.pucData;
+                SendEventStatistic(psRequest->ucPage);
+            }
+            else if(eCommand == eCmdSet)
+            {
+                EventQueue_ResetStatistic();
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        
+        case eUserMsgFlightRecorder:
+        {
+            if(eCommand == eCmdGet)
+            {
+                tMsgFlightRecRequest* psRequest = (tMsgFlightRecRequest*)psMsgFrame->sPayload.pucData;
+                SendFlightRecorder(psRequest->ucPage, psRequest->ucPreviousBoot != 0);
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        
+        case eUserMsgFlashStatistic:
+        {
+            if(eCommand == eCmdGet)
+            {
+                SendFlashStatistic();
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        
+        case eUserMsgFaultLog:
+        {
+            if(eCommand == eCmdGet)
+            {
+                tMsgStatisticRequest* psRequest = (tMsgStatisticRequest*)psMsgFrame->sPayload.pucData;
+                SendFaultLog(psRequest->ucPage);
+            }
+            else if(eCommand == eCmdSet)
+            {
+                FaultLog_Clear();
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        
+        case eUserMsgTimerTable:
+        {
+            if(eCommand == eCmdGet)
+            {
+                tMsgStatisticRequest* psRequest = (tMsgStatisticRequest*)psMsgFrame->sPayload.pucData;
+                SendTimerTableChunk(psRequest->ucPage);
+            }
+            else if(eCommand == eCmdSet)
+            {
+                tMsgTimerTableChunk* psChunk = (tMsgTimerTableChunk*)psMsgFrame->sPayload.pucData;
+                
+                if(ReceiveTimerTableChunk(psChunk) == false)
+                {
+                    eResponse = eTypeDenied;
+                }
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        
+        case eUserMsgSunTimer:
+        {
+            if(eCommand == eCmdGet)
+            {
+                SendSunTimer();
+            }
+            else if(eCommand == eCmdSet)
+            {
+                tMsgSunTimer* psMsgSunTimer = (tMsgSunTimer*)psMsgFrame->sPayload.pucData;
+                
+                if(ReceiveSunTimer(psMsgSunTimer) == false)
+                {
+                    eResponse = eTypeDenied;
+                }
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        
+        case eUserMsgScene:
+        {
+            if(eCommand == eCmdGet)
+            {
+                tMsgStatisticRequest* psRequest = (tMsgStatisticRequest*)psMsgFrame->sPayload.pucData;
+                SendScene(psRequest->ucPage);
+            }
+            else if(eCommand == eCmdSet)
+            {
+                tMsgScene* psMsgScene = (tMsgScene*)psMsgFrame->sPayload.pucData;
+                
+                if(ReceiveScene(psMsgScene) == false)
+                {
+                    eResponse = eTypeDenied;
+                }
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        
+        case eUserMsgMetering:
+        {
+            if(eCommand == eCmdGet)
+            {
+                tMsgStatisticRequest* psRequest = (tMsgStatisticRequest*)psMsgFrame->sPayload.pucData;
+                SendMetering(psRequest->ucPage);
+            }
+            else if(eCommand == eCmdSet)
+            {
+                tMsgMetering* psMsgMetering = (tMsgMetering*)psMsgFrame->sPayload.pucData;
+                
+                if((psMsgMetering->ucAction & (METERING_ACTION_ADAPTIVE | METERING_ACTION_RESET)) == 0)
+                {
+                    eResponse = eTypeDenied;
+                }
+                
+                if(psMsgMetering->ucAction & METERING_ACTION_RESET)
+                {
+                    Occupancy_Reset();
+                }
+                
+                if(psMsgMetering->ucAction & METERING_ACTION_ADAPTIVE)
+                {
+                    Occupancy_SetAdaptiveStatus(psMsgMetering->ucAdaptive != 0);
+                }
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        
+        #if PROFILER_ENABLE
+        case eUserMsgProfiler:
+        {
+            if(eCommand == eCmdGet)
+            {
+                tMsgStatisticRequest* psRequest = (tMsgStatisticRequest*)psMsgFrame->sPayload.pucData;
+                SendProfileEntry(psRequest->ucPage);
+            }
+            else if(eCommand == eCmdSet)
+            {
+                Profiler_Reset();
+            }
+            else
+            {
+                eResponse = eTypeDenied;
+            }
+            break;
+        }
+        #endif
+        
+        default:
+            eResponse = eTypeDenied;
+            break;
+    }
+    
+    return eResponse;
+}
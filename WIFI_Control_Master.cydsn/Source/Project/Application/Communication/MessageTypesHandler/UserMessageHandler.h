@@ -0,0 +1,26 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       UserMessageHandler.h
+\brief      Handler for the project specific messages
+
+***********************************************************************************/
+
+#ifndef _USERMESSAGEHANDLER_H_
+#define _USERMESSAGEHANDLER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    
+  
+#include "OS_Messages.h"
+teMessageType UserMsg_Handler(tsMessageFrame* psMsgFrame);
+
+#ifdef __cplusplus
+}
+#endif    
+
+#endif //_USERMESSAGEHANDLER_H_
@@ -0,0 +1,230 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       UserMessages.h
+\brief      Project specific messages which aren't part of the OS messages.
+            The IDs start behind the OS message IDs and are handled in the
+            UserMessageHandler.
+
+***********************************************************************************/
+
+#ifndef _USERMESSAGES_H_
+#define _USERMESSAGES_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif    
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "EventQueue.h"
+#include "FlightRecorder.h"
+#include "Profiler.h"
+#include "FaultLog.h"
+#include "TimerTable.h"
+#include "Scene.h"
+#include "Occupancy.h"
+
+/***************************** defines / macros ******************************/
+#define USER_MSG_ID_OFFSET          0x80    //First ID of the project messages
+
+/* Pages of the event statistic message */
+#define EVT_STAT_PAGE_OVERVIEW      0
+#define EVT_STAT_PAGE_SYSTEM        1
+#define EVT_STAT_PAGE_HISTOGRAM     2       //First histogram page. Two pages (waiting and execution time) per event ID
+#define EVT_STAT_PAGE_COUNT         (EVT_STAT_PAGE_HISTOGRAM + 2 * EVT_STAT_EVENT_IDS)
+
+/* Pages of the flight recorder message. Page zero is the summary, the entries follow */
+#define FLIGHT_REC_PAGE_SUMMARY     0
+#define FLIGHT_REC_ENTRIES_PER_PAGE 2
+
+/* Pages of the fault log message. Page zero is the summary, the entries follow from the oldest one */
+#define FAULT_LOG_PAGE_SUMMARY      0
+#define FAULT_LOG_ENTRIES_PER_PAGE  2
+
+/* Chunks of the timer table transfer. An empty table is sent in one chunk without entries */
+#define TIMER_TABLE_CHUNK_ENTRIES   4
+#define TIMER_TABLE_CHUNKS(count)   (((count) + TIMER_TABLE_CHUNK_ENTRIES - 1) / TIMER_TABLE_CHUNK_ENTRIES)
+
+/* Actions of the scene message. Both together store the scene and recall it afterwards */
+#define SCENE_ACTION_STORE          0x01
+#define SCENE_ACTION_RECALL         0x02
+
+/* Pages of the metering message. Each page holds the burn times of a part of the day */
+#define METERING_HOURS_PER_PAGE     12
+#define METERING_PAGE_COUNT         (OCCUPANCY_HOURS / METERING_HOURS_PER_PAGE)
+
+/* Actions of the metering message. A reset alone keeps the adaptive burn time as it is */
+#define METERING_ACTION_ADAPTIVE    0x01
+#define METERING_ACTION_RESET       0x02
+
+/****************************** type definitions *****************************/
+typedef enum
+{
+    eUserMsgEventStatistic = USER_MSG_ID_OFFSET,    /**< Get: Sends the requested page of the event loop statistic. Set: Resets the statistic */
+    eUserMsgFlightRecorder,                         /**< Get: Sends the requested page of the flight recorder */
+    eUserMsgProfiler,                               /**< Get: Sends the profile entry of the requested ID. Set: Resets the profiler */
+    eUserMsgFlashStatistic,                         /**< Get: Sends the write statistic of the settings in the flash */
+    eUserMsgFaultLog,                               /**< Get: Sends the requested page of the fault log. Set: Clears the fault log */
+    eUserMsgTimerTable,                             /**< Get: Sends the requested chunk of the timer table. Set: Receives the next chunk of a new table */
+    eUserMsgSunTimer,                               /**< Get: Sends the sun timer settings and the sun times of today. Set: Saves the sun timer settings */
+    eUserMsgScene,                                  /**< Get: Sends the requested scene. Set: Stores and/or recalls a scene */
+    eUserMsgMetering,                               /**< Get: Sends the saved energy and the learned burn times of the requested page. Set: Adaptive burn time on/off and reset */
+}teUserMessageId;
+
+typedef struct
+{
+    u8 ucPage;
+}tMsgStatisticRequest;
+
+typedef struct
+{
+    u8 ucPage;
+    u8 ucPreviousBoot;  //1 = Log before the last reset, 0 = Log of the running boot
+}tMsgFlightRecRequest;
+
+typedef struct
+{
+    u16 uiPosted;
+    u16 uiCoalesced;
+    u16 uiDeferred;
+    u16 auiOverflow[eEvtLane_Max];
+    u16 auiMaxWaitUs[eEvtLane_Max];
+    u16 auiAvgWaitUs[eEvtLane_Max];
+    u8  aucHighWater[eEvtLane_Max];
+    u8  ucPage;
+    u8  ucPageCount;
+}tMsgEventStatisticOverview;
+
+typedef struct
+{
+    u16 uiLightOnUs;
+    u16 uiLightOnMaxUs;
+    u16 uiActiveReachedMs;
+    u16 uiActiveReachedMaxMs;
+    u16 uiFastWakeCount;
+    u16 uiSelfTestPeriodMs;
+    u16 uiSelfTestPeriodMaxMs;
+    u16 uiSelfTestStepMaxUs;
+    u8  ucIdlePercent;
+    u8  ucPage;
+}tMsgSystemStatistic;
+
+typedef struct
+{
+    u16 auiBuckets[EVT_STAT_BUCKETS];
+    u8  ucEventId;
+    u8  ucExecTime;     //0 = Waiting time in the queue, 1 = Execution time of the handlers
+    u8  ucPage;
+    u8  ucPageCount;
+}tMsgEventHistogram;
+
+typedef struct
+{
+    u32 ulResetReason;
+    u16 uiBootCount;
+    u16 uiEntryCount;
+    u8  ucPage;
+    u8  ucPageCount;
+    u8  ucPreviousBoot;
+    u8  ucReserved;
+}tMsgFlightRecSummary;
+
+typedef struct
+{
+    tsFlightRecEntry asEntries[FLIGHT_REC_ENTRIES_PER_PAGE];
+    u8  ucPage;
+    u8  ucPageCount;
+    u8  ucPreviousBoot;
+    u8  ucEntryCount;   //Valid entries of this page
+}tMsgFlightRecEntries;
+
+typedef struct
+{
+    u32 ulCount;
+    u16 uiMinUs;
+    u16 uiAvgUs;
+    u16 uiMaxUs;
+    u8  ucProfileId;
+    u8  ucProfileCount;
+}tMsgProfileEntry;
+
+typedef struct
+{
+    u32 ulProgrammedBytes;      //Erased and programmed bytes. Always complete rows
+    u16 uiUserWrites;
+    u16 uiSystemWrites;
+    u16 uiFailedWrites;
+    u16 uiSkippedIdentical;
+    u16 uiForcedWrites;
+    u16 uiStandbyWrites;
+    u16 uiJournalCompactions;
+    u16 uiJournalFreeRecords;
+    u16 uiJournalMaxRowWrites;  //Erase cycles of the most used journal row since the start
+    u16 uiReserved;
+}tMsgFlashStatistic;
+
+typedef struct
+{
+    u16 uiEntryCount;
+    u16 uiLostCount;
+    u8  ucPage;
+    u8  ucPageCount;
+}tMsgFaultLogSummary;
+
+typedef struct
+{
+    tsFaultLogEntry asEntries[FAULT_LOG_ENTRIES_PER_PAGE];
+    u8  ucPage;
+    u8  ucPageCount;
+    u8  ucEntryCount;   //Valid entries of this page
+    u8  ucReserved;
+}tMsgFaultLogEntries;
+
+typedef struct
+{
+    u32 ulTableCrc;     //CRC of all entries. Is checked with the last chunk of an upload
+    u8  ucChunk;        //Chunk zero starts an upload
+    u8  ucEntryCount;   //Entries of the whole table
+    u8  ucChunkEntries; //Valid entries of this chunk
+    u8  ucReserved;
+    tsTimerEntry asEntries[TIMER_TABLE_CHUNK_ENTRIES];
+}tMsgTimerTableChunk;
+
+typedef struct
+{
+    s16 siLatitude;     //1/100 degree. North is positive
+    s16 siLongitude;    //1/100 degree. East is positive
+    u16 uiSunrise;      //Local minute of the day. Only sent. SUN_TIME_INVALID without sunrise
+    u16 uiSunset;       //Local minute of the day. Only sent
+    s8  scDuskOffset;   //Minutes added to the sunset where the slot starts
+    s8  scDawnOffset;   //Minutes added to the sunrise where the slot ends
+    u8  ucActive;
+    u8  ucReserved;
+}tMsgSunTimer;
+
+typedef struct
+{
+    tsScene sScene;     //Values of the scene. Only used to store a scene
+    u8  ucScene;        //Index of the scene
+    u8  ucAction;       //SCENE_ACTION_STORE and SCENE_ACTION_RECALL. Only used by set
+}tMsgScene;
+
+typedef struct
+{
+    tsOccupancyStatistic sStatistic;                //Only sent
+    u8  aucBurnTime[METERING_HOURS_PER_PAGE];       //Burn time in minutes of each hour of the page. Only sent
+    u8  ucPage;
+    u8  ucConfiguredBurnTime;                       //Only sent
+    u8  ucAdaptive;                                 //1 = The learned burn time is used. Set: Only used with METERING_ACTION_ADAPTIVE
+    u8  ucAction;                                   //METERING_ACTION_ADAPTIVE and METERING_ACTION_RESET. Only used by set
+}tMsgMetering;
+
+#ifdef __cplusplus
+}
+#endif    
+
+#endif //_USERMESSAGES_H_
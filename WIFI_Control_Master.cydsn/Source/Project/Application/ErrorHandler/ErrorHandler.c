@@ -5,6 +5,9 @@
 /********************************* includes **********************************/
 #include "OS_EventManager.h"
 #include "ErrorHandler.h"
+#include "FlightRecorder.h"
+#include "FaultLog.h"
+#include "EventQueue.h"
 
 /***************************** defines / macros ******************************/
 
@@ -36,13 +39,17 @@ bool ErrorHandler_HandleActualError(teErrorList eFaultCode, bool bSetError)
 {    
     bool bErrorHandled = true;
     
+    FlightRecorder_Record(eFlightRec_Fault, (u8)eFaultCode, bSetError, 0);
+    
     if(bSetError)
     {        
+        FaultLog_Record(eFaultCode);
+        
         switch(eFaultCode)
         {           
             case eCommunicationTimeoutFault:
             {
-                OS_EVT_PostEvent(eEvtCommTimeout, 0, 0);
+                EventQueue_PostToOs(eEvtCommTimeout, 0, 0);
                 //bErrorHandled = false;
                 break;
             }
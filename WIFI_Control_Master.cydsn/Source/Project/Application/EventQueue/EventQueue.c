@@ -0,0 +1,648 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       EventQueue.c
+\brief      The events of the OS event manager are taken over into two lanes with
+            their own depth. The main task takes the events of the high priority
+            lane first. Thus the timer ticks aren't delayed by a burst of
+            regulation or communication events.
+            Each event is time stamped when it is posted into the lanes or into
+            the OS event manager with EventQueue_PostToOs. Events which the OS
+            posts itself get the time stamp when they are taken over. An event
+            whose lane is full is parked until the lane has space. Until then
+            no further event is taken from the OS event manager, so no event
+            is lost and all events keep their order.
+            The waiting and execution times are collected into small histograms
+            per event ID.
+
+***********************************************************************************/
+#include "OS_Config.h"
+#include "EventQueue.h"
+#include "DR_System.h"
+
+/****************************************** Defines ******************************************************/
+typedef struct
+{
+    tsEventMsg sEvt;
+    u32 ulPostCycles;       //Cycle count when the event was posted or taken from the OS event manager
+    bool bLatestWins;       //Pending event may be overwritten by a newer one
+}tsEventEntry;
+
+typedef struct
+{
+    tsEventEntry* psEntries;
+    u8 ucSize;
+    u8 ucHead;
+    u8 ucCount;
+}tsEventLane;
+
+typedef struct
+{
+    tsEventMsg sEvt;
+    u32 ulPostCycles;
+}tsOsPostStamp;
+
+/****************************************** Variables ****************************************************/
+static tsEventEntry sHighEntries[EVT_QUEUE_HIGH_SIZE];
+static tsEventEntry sLowEntries[EVT_QUEUE_LOW_SIZE];
+
+static tsEventLane sLanes[eEvtLane_Max] =
+{
+    {sHighEntries, EVT_QUEUE_HIGH_SIZE, 0, 0},
+    {sLowEntries, EVT_QUEUE_LOW_SIZE, 0, 0}
+};
+
+static tsEventLaneStatistic sLaneStatistic[eEvtLane_Max];
+static tsEventPostStatistic sPostStatistic;
+
+/* Event from the OS event manager which didn't fit into its full lane */
+static tsEventEntry sHeldEntry;
+
+/* Time stamps of the events in the OS event manager in the order of their post */
+static tsOsPostStamp sOsStamps[EVT_OS_STAMP_SIZE];
+static u8 ucStampHead = 0;
+static u8 ucStampCount = 0;
+static tsEventHistogram sHistogram[EVT_STAT_EVENT_IDS];
+
+/* Upper limits of the histogram buckets in us. The last bucket takes the rest */
+static const u16 uiBucketLimitUs[EVT_STAT_BUCKETS - 1] = {50, 200, 1000, 5000, 20000};
+
+/****************************************** Function prototypes ******************************************/
+static teEventLane GetEventLane(teEventID eEventID);
+static void PutInLane(tsEventLane* psLane, const tsEventMsg* psEvt, bool bLatestWins, u32 ulPostCycles);
+static tsEventEntry* FindPendingEntry(tsEventLane* psLane, const tsEventMsg* psEvt, teEventPostMode eMode);
+static void RemoveEntry(tsEventLane* psLane, const tsEventEntry* psEntry);
+static void PutInHistogram(u16* puiBuckets, u32 ulTimeUs);
+static u32  TakeOsPostStamp(const tsEventMsg* psEvt);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the lane of the given event. The high priority events are
+            configured with USER_EVENT_HIGH_PRIO_LIST.
+\return     teEventLane - The lane of the event
+\param      eEventID - The event which shall be sorted
+***********************************************************************************/
+static teEventLane GetEventLane(teEventID eEventID)
+{
+    teEventLane eLane = eEvtLane_Low;
+
+    switch(eEventID)
+    {
+        #define EVT_PRIO_HIGH(EventId) case EventId:
+            USER_EVENT_HIGH_PRIO_LIST
+        #undef EVT_PRIO_HIGH
+        {
+            eLane = eEvtLane_High;
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return eLane;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Increments the bucket of the given time. The counters saturate.
+\return     none
+\param      puiBuckets - The bucket array with EVT_STAT_BUCKETS entries
+\param      ulTimeUs - The measured time in us
+***********************************************************************************/
+static void PutInHistogram(u16* puiBuckets, u32 ulTimeUs)
+{
+    u8 ucBucketIdx = 0;
+
+    while(ucBucketIdx < _countof(uiBucketLimitUs) && ulTimeUs >= uiBucketLimitUs[ucBucketIdx])
+    {
+        ucBucketIdx++;
+    }
+
+    if(puiBuckets[ucBucketIdx] < 0xFFFF)
+    {
+        puiBuckets[ucBucketIdx]++;
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Appends the event at the end of the lane. The lane has to be checked
+            for free space before.
+\return     none
+\param      psLane - The lane which shall be used
+\param      psEvt - The event which shall be appended
+\param      bLatestWins - True when the event may be overwritten while pending
+\param      ulPostCycles - Time stamp of the event
+***********************************************************************************/
+static void PutInLane(tsEventLane* psLane, const tsEventMsg* psEvt, bool bLatestWins, u32 ulPostCycles)
+{
+    u8 ucTail = psLane->ucHead + psLane->ucCount;
+    if(ucTail >= psLane->ucSize)
+    {
+        ucTail -= psLane->ucSize;
+    }
+
+    psLane->psEntries[ucTail].sEvt = *psEvt;
+    psLane->psEntries[ucTail].ulPostCycles = ulPostCycles;
+    psLane->psEntries[ucTail].bLatestWins = bLatestWins;
+    psLane->ucCount++;
+
+    /* Remember the maximum queue depth */
+    tsEventLaneStatistic* psStatistic = &sLaneStatistic[psLane - sLanes];
+    if(psLane->ucCount > psStatistic->ucHighWater)
+    {
+        psStatistic->ucHighWater = psLane->ucCount;
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Searches a pending event which matches the given event in dependency
+            of the post mode.
+\return     psEntry - The pending entry or NULL when no entry matches
+\param      psLane - The lane which shall be searched
+\param      psEvt - The new event
+\param      eMode - Unique compares all values. LatestWins compares the event ID
+                    and param2 of the entries which were posted with the same mode.
+***********************************************************************************/
+static tsEventEntry* FindPendingEntry(tsEventLane* psLane, const tsEventMsg* psEvt, teEventPostMode eMode)
+{
+    tsEventEntry* psEntry = NULL;
+
+    u8 ucEntryIdx = psLane->ucHead;
+    u8 ucCount;
+    for(ucCount = 0; ucCount < psLane->ucCount && psEntry == NULL; ucCount++)
+    {
+        tsEventEntry* psPending = &psLane->psEntries[ucEntryIdx];
+
+        if(psPending->sEvt.eEventID == psEvt->eEventID && psPending->sEvt.param2 == psEvt->param2)
+        {
+            if(eMode == eEvtPost_Unique && psPending->sEvt.param1 == psEvt->param1)
+            {
+                psEntry = psPending;
+            }
+            else if(eMode == eEvtPost_LatestWins && psPending->bLatestWins)
+            {
+                psEntry = psPending;
+            }
+        }
+
+        if(++ucEntryIdx >= psLane->ucSize)
+        {
+            ucEntryIdx = 0;
+        }
+    }
+
+    return psEntry;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Removes a pending entry from the lane. The following entries move
+            up by one to keep their order.
+\return     none
+\param      psLane - The lane which contains the entry
+\param      psEntry - The entry which shall be removed
+***********************************************************************************/
+static void RemoveEntry(tsEventLane* psLane, const tsEventEntry* psEntry)
+{
+    u8 ucEntryIdx = (u8)(psEntry - psLane->psEntries);
+    u8 ucTail = psLane->ucHead + psLane->ucCount - 1;
+    if(ucTail >= psLane->ucSize)
+    {
+        ucTail -= psLane->ucSize;
+    }
+
+    while(ucEntryIdx != ucTail)
+    {
+        u8 ucNextIdx = ucEntryIdx + 1;
+        if(ucNextIdx >= psLane->ucSize)
+        {
+            ucNextIdx = 0;
+        }
+
+        psLane->psEntries[ucEntryIdx] = psLane->psEntries[ucNextIdx];
+        ucEntryIdx = ucNextIdx;
+    }
+
+    psLane->ucCount--;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Searches the time stamp of an event which was taken from the OS event
+            manager. The stamps are in the same order as the events, so older
+            stamps in front of the match belong to lost events and are removed.
+\return     u32 - The time stamp of the post. The current time when the event
+                  was posted without EventQueue_PostToOs
+\param      psEvt - The event from the OS event manager
+***********************************************************************************/
+static u32 TakeOsPostStamp(const tsEventMsg* psEvt)
+{
+    u32 ulPostCycles = DR_System_GetCycleCount();
+
+    const u8 ucCriticalSection = EnterCritical();
+
+    u8 ucStampIdx = ucStampHead;
+    u8 ucCount;
+    for(ucCount = 0; ucCount < ucStampCount; ucCount++)
+    {
+        const tsOsPostStamp* psStamp = &sOsStamps[ucStampIdx];
+
+        if(++ucStampIdx >= EVT_OS_STAMP_SIZE)
+        {
+            ucStampIdx = 0;
+        }
+
+        if(psStamp->sEvt.eEventID == psEvt->eEventID
+            && psStamp->sEvt.param1 == psEvt->param1
+            && psStamp->sEvt.param2 == psEvt->param2)
+        {
+            ulPostCycles = psStamp->ulPostCycles;
+            ucStampHead = ucStampIdx;
+            ucStampCount -= ucCount + 1;
+            break;
+        }
+    }
+
+    LeaveCritical(ucCriticalSection);
+
+    return ulPostCycles;
+}
+
+/****************************************** External visible functiones **********************************/
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Clears all lanes and statistics
+\return     none
+\param      none
+***********************************************************************************/
+void EventQueue_Init(void)
+{
+    u8 ucLaneIdx;
+    for(ucLaneIdx = 0; ucLaneIdx < eEvtLane_Max; ucLaneIdx++)
+    {
+        sLanes[ucLaneIdx].ucHead = 0;
+        sLanes[ucLaneIdx].ucCount = 0;
+    }
+
+    sHeldEntry.sEvt.eEventID = eEvtNone;
+
+    ucStampHead = 0;
+    ucStampCount = 0;
+
+    EventQueue_ResetStatistic();
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Takes all pending events from the OS event manager and sorts them
+            into the lanes. An event whose lane is full is parked. The events
+            behind it stay in the OS event manager until the lane has space.
+\return     ucIngested - The amount of events which were taken over
+\param      none
+***********************************************************************************/
+u8 EventQueue_Ingest(void)
+{
+    u8 ucIngested = 0;
+
+    /* The parked event is put in first to keep the order of the events */
+    if(sHeldEntry.sEvt.eEventID != eEvtNone)
+    {
+        tsEventLane* psLane = &sLanes[GetEventLane(sHeldEntry.sEvt.eEventID)];
+
+        if(psLane->ucCount >= psLane->ucSize)
+        {
+            return ucIngested;
+        }
+
+        PutInLane(psLane, &sHeldEntry.sEvt, false, sHeldEntry.ulPostCycles);
+        sHeldEntry.sEvt.eEventID = eEvtNone;
+        ucIngested++;
+    }
+
+    while(1)
+    {
+        tsEventMsg sEvt;
+        OS_EVT_GetEvent(&sEvt);
+
+        if(sEvt.eEventID == eEvtNone)
+        {
+            break;
+        }
+
+        const u32 ulPostCycles = TakeOsPostStamp(&sEvt);
+        const teEventLane eLane = GetEventLane(sEvt.eEventID);
+        tsEventLane* psLane = &sLanes[eLane];
+
+        if(psLane->ucCount >= psLane->ucSize)
+        {
+            /* Wait for space. The following events stay in the OS event manager */
+            sLaneStatistic[eLane].ulOverflowCnt++;
+            sHeldEntry.sEvt = sEvt;
+            sHeldEntry.ulPostCycles = ulPostCycles;
+            break;
+        }
+
+        PutInLane(psLane, &sEvt, false, ulPostCycles);
+        ucIngested++;
+    }
+
+    return ucIngested;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the oldest event of the highest priority lane which isn't
+            empty and updates the waiting time statistic of this lane.
+\return     bEventFound - True when an event was copied into the structure
+\param      psEvt - Pointer to the event structure which shall be filled
+***********************************************************************************/
+bool EventQueue_GetEvent(tsEventMsg* psEvt)
+{
+    bool bEventFound = false;
+
+    u8 ucLaneIdx;
+    for(ucLaneIdx = 0; ucLaneIdx < eEvtLane_Max && psEvt; ucLaneIdx++)
+    {
+        tsEventLane* psLane = &sLanes[ucLaneIdx];
+
+        if(psLane->ucCount)
+        {
+            const tsEventEntry* psEntry = &psLane->psEntries[psLane->ucHead];
+            *psEvt = psEntry->sEvt;
+
+            if(++psLane->ucHead >= psLane->ucSize)
+            {
+                psLane->ucHead = 0;
+            }
+            psLane->ucCount--;
+
+            /* Calculate the waiting time in the queue */
+            tsEventLaneStatistic* psStatistic = &sLaneStatistic[ucLaneIdx];
+            const u32 ulWaitUs = DR_System_CyclesToUs(DR_System_GetCycleCount() - psEntry->ulPostCycles);
+
+            psStatistic->uiLastWaitUs = (ulWaitUs > 0xFFFF) ? 0xFFFF : (u16)ulWaitUs;
+            if(psStatistic->uiLastWaitUs > psStatistic->uiMaxWaitUs)
+            {
+                psStatistic->uiMaxWaitUs = psStatistic->uiLastWaitUs;
+            }
+            psStatistic->ulSumWaitUs += ulWaitUs;
+            psStatistic->ulEventCnt++;
+
+            /* IDs above the statistic range share the last entry */
+            const u8 ucStatIdx = (psEvt->eEventID < EVT_STAT_EVENT_IDS) ? psEvt->eEventID : (EVT_STAT_EVENT_IDS - 1);
+            PutInHistogram(sHistogram[ucStatIdx].auiWaitUs, ulWaitUs);
+
+            bEventFound = true;
+            break;
+        }
+    }
+
+    return bEventFound;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Checks if all lanes are empty
+\return     bEmpty - True when no event is pending in any lane
+\param      none
+***********************************************************************************/
+bool EventQueue_IsEmpty(void)
+{
+    bool bEmpty = true;
+
+    u8 ucLaneIdx;
+    for(ucLaneIdx = 0; ucLaneIdx < eEvtLane_Max; ucLaneIdx++)
+    {
+        if(sLanes[ucLaneIdx].ucCount)
+        {
+            bEmpty = false;
+        }
+    }
+
+    if(sHeldEntry.sEvt.eEventID != eEvtNone)
+    {
+        bEmpty = false;
+    }
+
+    return bEmpty;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Posts an event directly into its lane. In contrast to OS_EVT_PostEvent
+            redundant events can be coalesced with a pending one. The events
+            from the OS event manager are taken over first, so they stay in
+            front of the new event. When the lane is full the event is posted
+            to the OS event manager instead.
+            Shall only be called from the main context.
+\return     none
+\param      eEventID - The event which shall be posted
+\param      uiParam1 - First event parameter
+\param      ulParam2 - Second event parameter
+\param      eMode - Defines how the event is handled when a similar one is pending
+***********************************************************************************/
+void EventQueue_PostEvent(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2 ulParam2, teEventPostMode eMode)
+{
+    const tsEventMsg sEvt = {eEventID, uiParam1, ulParam2};
+    tsEventLane* psLane = &sLanes[GetEventLane(eEventID)];
+    tsEventEntry* psPending = NULL;
+
+    sPostStatistic.ulPosted++;
+
+    /* Keep the order to the events which were posted earlier from other contexts */
+    EventQueue_Ingest();
+
+    if(eMode != eEvtPost_Append)
+    {
+        psPending = FindPendingEntry(psLane, &sEvt, eMode);
+    }
+
+    if(psPending && eMode == eEvtPost_Unique)
+    {
+        sPostStatistic.ulDiscarded++;
+    }
+    else if(psPending && eMode == eEvtPost_LatestWins)
+    {
+        /* The old value is replaced. The new one is ordered behind all events
+           which were posted in between */
+        RemoveEntry(psLane, psPending);
+        PutInLane(psLane, &sEvt, true, DR_System_GetCycleCount());
+        sPostStatistic.ulMerged++;
+    }
+    else if(psLane->ucCount < psLane->ucSize)
+    {
+        PutInLane(psLane, &sEvt, (eMode == eEvtPost_LatestWins), DR_System_GetCycleCount());
+    }
+    else
+    {
+        EventQueue_PostToOs(eEventID, uiParam1, ulParam2);
+        sPostStatistic.ulDeferred++;
+        sLaneStatistic[psLane - sLanes].ulOverflowCnt++;
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Posts an event into the OS event manager and remembers the time of
+            the post for the waiting time statistic. Can be called from an
+            interrupt. When all stamps are used the event is stamped when it
+            is taken over.
+\return     none
+\param      eEventID - The event which shall be posted
+\param      uiParam1 - First event parameter
+\param      ulParam2 - Second event parameter
+***********************************************************************************/
+void EventQueue_PostToOs(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2 ulParam2)
+{
+    const u8 ucCriticalSection = EnterCritical();
+
+    if(ucStampCount < EVT_OS_STAMP_SIZE)
+    {
+        u8 ucTail = ucStampHead + ucStampCount;
+        if(ucTail >= EVT_OS_STAMP_SIZE)
+        {
+            ucTail -= EVT_OS_STAMP_SIZE;
+        }
+
+        sOsStamps[ucTail].sEvt.eEventID = eEventID;
+        sOsStamps[ucTail].sEvt.param1 = uiParam1;
+        sOsStamps[ucTail].sEvt.param2 = ulParam2;
+        sOsStamps[ucTail].ulPostCycles = DR_System_GetCycleCount();
+        ucStampCount++;
+    }
+
+    OS_EVT_PostEvent(eEventID, uiParam1, ulParam2);
+
+    LeaveCritical(ucCriticalSection);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the statistic of the coalesced events
+\return     sPostStatistic - Pointer to the statistic (read-only)
+\param      none
+***********************************************************************************/
+const tsEventPostStatistic* EventQueue_GetPostStatistic(void)
+{
+    return &sPostStatistic;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Puts the execution time of the state handlers for the given event
+            into its histogram.
+\return     none
+\param      eEventID - The event which was handled
+\param      ulExecUs - The execution time in us
+***********************************************************************************/
+void EventQueue_RecordExecution(teEventID eEventID, u32 ulExecUs)
+{
+    const u8 ucStatIdx = (eEventID < EVT_STAT_EVENT_IDS) ? eEventID : (EVT_STAT_EVENT_IDS - 1);
+    PutInHistogram(sHistogram[ucStatIdx].auiExecUs, ulExecUs);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the histograms of the given event ID
+\return     tsEventHistogram - Pointer to the histograms (read-only) or NULL
+\param      ucEventId - The event ID of the histogram
+***********************************************************************************/
+const tsEventHistogram* EventQueue_GetHistogram(u8 ucEventId)
+{
+    const tsEventHistogram* psHistogram = NULL;
+
+    if(ucEventId < EVT_STAT_EVENT_IDS)
+    {
+        psHistogram = &sHistogram[ucEventId];
+    }
+
+    return psHistogram;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the waiting time statistic of the given lane
+\return     tsEventLaneStatistic - Pointer to the statistic (read-only) or NULL
+\param      eLane - The lane of the statistic
+***********************************************************************************/
+const tsEventLaneStatistic* EventQueue_GetLaneStatistic(teEventLane eLane)
+{
+    const tsEventLaneStatistic* psStatistic = NULL;
+
+    if(eLane < eEvtLane_Max)
+    {
+        psStatistic = &sLaneStatistic[eLane];
+    }
+
+    return psStatistic;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Resets the lane statistics, the post statistic and the histograms
+\return     none
+\param      none
+***********************************************************************************/
+void EventQueue_ResetStatistic(void)
+{
+    memset(sLaneStatistic, 0, sizeof(sLaneStatistic));
+    memset(&sPostStatistic, 0, sizeof(sPostStatistic));
+    memset(sHistogram, 0, sizeof(sHistogram));
+}
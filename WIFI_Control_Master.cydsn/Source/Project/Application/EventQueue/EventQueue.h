@@ -0,0 +1,84 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       EventQueue.h
+\brief      Prioritized event queue between the OS event manager and the main task
+
+***********************************************************************************/
+#ifndef _EVENTQUEUE_H_
+#define _EVENTQUEUE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "OS_EventManager.h"
+
+/***************************** defines / macros ******************************/
+
+/****************************** type definitions *****************************/
+typedef enum
+{
+    eEvtLane_High,      /**< Timer ticks which shall preempt the other events */
+    eEvtLane_Low,       /**< Housekeeping and communication events */
+    eEvtLane_Max
+}teEventLane;
+
+typedef enum
+{
+    eEvtPost_Append,        /**< Event is always appended */
+    eEvtPost_Unique,        /**< Event is discarded when an identical event is pending */
+    eEvtPost_LatestWins     /**< A pending event with the same ID and param2 is removed and the new one is appended */
+}teEventPostMode;
+
+typedef struct
+{
+    u32 ulEventCnt;     //Amount of events which were taken from this lane
+    u32 ulSumWaitUs;    //Sum of the waiting times. Used for the average
+    u32 ulOverflowCnt;  //How often the lane was full when an event had to be put in
+    u16 uiLastWaitUs;   //Waiting time of the last event
+    u16 uiMaxWaitUs;    //Maximum waiting time since the last reset
+    u8  ucHighWater;    //Maximum amount of pending events since the last reset
+}tsEventLaneStatistic;
+
+typedef struct
+{
+    u32 ulPosted;       //Amount of events posted with EventQueue_PostEvent
+    u32 ulDiscarded;    //Identical events which were already pending
+    u32 ulMerged;       //Events which overwrote a pending event
+    u32 ulDeferred;     //Events which were handed over to the OS event manager because the lane was full
+}tsEventPostStatistic;
+
+typedef struct
+{
+    u16 auiWaitUs[EVT_STAT_BUCKETS];    //Queue waiting time from post to dispatch
+    u16 auiExecUs[EVT_STAT_BUCKETS];    //Execution time of the state handlers
+}tsEventHistogram;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    EventQueue_Init(void);
+u8      EventQueue_Ingest(void);
+bool    EventQueue_GetEvent(tsEventMsg* psEvt);
+bool    EventQueue_IsEmpty(void);
+void    EventQueue_PostEvent(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2 ulParam2, teEventPostMode eMode);
+void    EventQueue_PostToOs(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2 ulParam2);
+
+const tsEventLaneStatistic* EventQueue_GetLaneStatistic(teEventLane eLane);
+const tsEventPostStatistic* EventQueue_GetPostStatistic(void);
+const tsEventHistogram* EventQueue_GetHistogram(u8 ucEventId);
+void    EventQueue_RecordExecution(teEventID eEventID, u32 ulExecUs);
+void    EventQueue_ResetStatistic(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_EVENTQUEUE_H_
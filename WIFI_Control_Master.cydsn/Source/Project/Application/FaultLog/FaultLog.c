@@ -0,0 +1,619 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       FaultLog.c
+\brief      Ring of the set faults in an own flash area. Each entry holds the
+            fault code, the RTC time and a snapshot of the output. The entries
+            are collected in the RAM copy of the head row. A full row is moved
+            into a second RAM row for the write, so the next faults go at once
+            into the following row. A partial row is written when the oldest
+            unwritten entry is older than FAULT_LOG_FLUSH_DELAY_MS, when the
+            standby is entered and before each deep sleep, because the tick
+            stops there. A clear writes a marker entry instead of erasing the
+            rows. The entries behind the newest marker are shown.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "OS_Config.h"
+#include "DR_Flash.h"
+#include "DR_System.h"
+#include "Aom.h"
+#include "Aom_Time.h"
+#include "FaultLog.h"
+
+/****************************************** Defines ******************************************************/
+#define FAULT_LOG_ENTRIES_PER_ROW   (CY_FLASH_SIZEOF_ROW / sizeof(tsFaultLogEntry))
+#define FAULT_LOG_ENTRIES           (FAULT_LOG_ROWS * FAULT_LOG_ENTRIES_PER_ROW)
+#define FAULT_LOG_CLEAR_MARKER      0x80    //Flag in the output index of a clear entry
+#define FAULT_OUTPUTS_PER_TYPE      4       //The output faults of the USER_ERROR_LIST exist for the outputs 0..3
+
+/****************************************** Variables ****************************************************/
+/* Row aligned flash area of the fault log. Is read volatile because the content is changed by the flash writes */
+static const volatile u8 ucFaultLogFlash[FAULT_LOG_ROWS * CY_FLASH_SIZEOF_ROW] CY_ALIGN(CY_FLASH_SIZEOF_ROW) = {0};
+
+static tsFaultLogEntry sHeadRow[FAULT_LOG_ENTRIES_PER_ROW];
+static u8   ucHeadRow = 0;
+static u8   ucRowEntries = 0;           //Entries in the head row
+static u8   ucWrittenEntries = 0;       //Entries of the head row which are in the flash
+static u8   ucWriteEntries = 0;         //Entries of the running write
+
+static tsFaultLogEntry sFullRow[FAULT_LOG_ENTRIES_PER_ROW];
+static u8   ucFullRow = 0;
+static bool bFullRowPending = false;    //The full row isn't in the flash yet
+
+static u16  uiNextSequence = 1;
+static u16  uiLostCount = 0;            //Faults which were lost because both RAM rows were full
+static bool bClearPending = false;      //The clear marker is added when the head row has space again
+
+static u32  ulFirstPendingTick = 0;     //Tick of the oldest entry which isn't written
+static bool bFlushRequested = false;
+static bool bWriteRunning = false;
+static bool bWritingFullRow = false;    //The running write is the one of the full row
+static u8   ucWriteRow = 0;             //Row of the running write
+static u8   ucRetries = 0;
+
+/****************************************** Function prototypes ******************************************/
+static u8   CalculateCheck(const tsFaultLogEntry* psEntry);
+static bool ReadFlashEntry(u16 uiSlot, tsFaultLogEntry* psEntry);
+static bool ReadEntry(u16 uiSlot, tsFaultLogEntry* psEntry);
+static bool IsNewer(u16 uiSequence, u16 uiReference);
+static u16  GetFaultCode(teErrorList eFault);
+static u8   GetOutputIdx(teErrorList eFault);
+static bool AddEntry(tsFaultLogEntry* psEntry);
+static void AddClearMarker(void);
+static void RetireHeadRow(void);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the check byte of an entry. An erased entry is invalid
+            for both erased values.
+\return     u8 - The inverted sum of all bytes without the check byte
+\param      psEntry - The entry
+***********************************************************************************/
+static u8 CalculateCheck(const tsFaultLogEntry* psEntry)
+{
+    const u8* pucEntry = (const u8*)psEntry;
+    u8 ucSum = 0;
+
+    u8 ucByteIdx;
+    for(ucByteIdx = 0; ucByteIdx < sizeof(tsFaultLogEntry) - 1; ucByteIdx++)
+    {
+        ucSum += pucEntry[ucByteIdx];
+    }
+
+    return (u8)~ucSum;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads an entry from the flash.
+\return     bool - True when the check byte is valid
+\param      uiSlot - Index of the entry in the flash area
+\param      psEntry - Pointer to the entry which shall be filled
+***********************************************************************************/
+static bool ReadFlashEntry(u16 uiSlot, tsFaultLogEntry* psEntry)
+{
+    const volatile u8* pucFlash = &ucFaultLogFlash[uiSlot * sizeof(tsFaultLogEntry)];
+    u8* pucEntry = (u8*)psEntry;
+
+    u8 ucByteIdx;
+    for(ucByteIdx = 0; ucByteIdx < sizeof(tsFaultLogEntry); ucByteIdx++)
+    {
+        pucEntry[ucByteIdx] = pucFlash[ucByteIdx];
+    }
+
+    return (psEntry->ucCheck == CalculateCheck(psEntry));
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads an entry of the ring. The head row and the full row are taken
+            from the RAM because they contain the entries which aren't written
+            yet.
+\return     bool - True when the entry is valid
+\param      uiSlot - Index of the entry in the ring
+\param      psEntry - Pointer to the entry which shall be filled
+***********************************************************************************/
+static bool ReadEntry(u16 uiSlot, tsFaultLogEntry* psEntry)
+{
+    if(uiSlot / FAULT_LOG_ENTRIES_PER_ROW == ucHeadRow)
+    {
+        const u8 ucRowSlot = uiSlot % FAULT_LOG_ENTRIES_PER_ROW;
+
+        if(ucRowSlot >= ucRowEntries)
+        {
+            return false;
+        }
+
+        *psEntry = sHeadRow[ucRowSlot];
+        return true;
+    }
+
+    if(bFullRowPending && uiSlot / FAULT_LOG_ENTRIES_PER_ROW == ucFullRow)
+    {
+        *psEntry = sFullRow[uiSlot % FAULT_LOG_ENTRIES_PER_ROW];
+        return true;
+    }
+
+    return ReadFlashEntry(uiSlot, psEntry);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Compares two sequence numbers. The difference handles the overflow.
+\return     bool - True when the sequence is newer than the reference
+\param      uiSequence - The sequence which shall be checked
+\param      uiReference - The reference sequence
+***********************************************************************************/
+static bool IsNewer(u16 uiSequence, u16 uiReference)
+{
+    return ((s16)(uiSequence - uiReference) > 0);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the fault code of the USER_ERROR_LIST.
+\return     u16 - The fault code. Faults of the OS return their ID
+\param      eFault - The fault
+***********************************************************************************/
+static u16 GetFaultCode(teErrorList eFault)
+{
+    switch(eFault)
+    {
+        #define ERROR(name, code, priority, debounce) case name: return code;
+            USER_ERROR_LIST
+        #undef ERROR
+
+        default:
+            return (u16)eFault;
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the output of an output fault. The voltage, current, load
+            and temperature faults are listed for each output in a row.
+\return     u8 - The output index or FAULT_LOG_NO_OUTPUT
+\param      eFault - The fault
+***********************************************************************************/
+static u8 GetOutputIdx(teErrorList eFault)
+{
+    if(eFault >= eOutputVoltageFault_0 && eFault <= eOverTemperatureFault_3)
+    {
+        return (u8)((eFault - eOutputVoltageFault_0) % FAULT_OUTPUTS_PER_TYPE);
+    }
+
+    return FAULT_LOG_NO_OUTPUT;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Adds the entry with the next sequence into the head row. A full
+            row is moved for the write at once.
+\return     bool - False when the head row and the full row are both waiting
+                   for the write
+\param      psEntry - The entry. Sequence and check byte are set here
+***********************************************************************************/
+static bool AddEntry(tsFaultLogEntry* psEntry)
+{
+    if(ucRowEntries >= FAULT_LOG_ENTRIES_PER_ROW)
+    {
+        if(uiLostCount < 0xFFFF)
+        {
+            uiLostCount++;
+        }
+        return false;
+    }
+
+    /* Start the flush delay with the first unwritten entry */
+    if(ucRowEntries == ucWrittenEntries)
+    {
+        ulFirstPendingTick = DR_System_GetTickMs();
+    }
+
+    psEntry->uiSequence = uiNextSequence++;
+    psEntry->ucCheck = CalculateCheck(psEntry);
+
+    sHeadRow[ucRowEntries++] = *psEntry;
+
+    if(ucRowEntries >= FAULT_LOG_ENTRIES_PER_ROW && bFullRowPending == false)
+    {
+        RetireHeadRow();
+    }
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Adds the clear marker and writes it at once. When the head row has
+            no space the marker is added after the write of the full row.
+\return     none
+\param      none
+***********************************************************************************/
+static void AddClearMarker(void)
+{
+    tsFaultLogEntry sEntry;
+    memset(&sEntry, 0, sizeof(sEntry));
+
+    sEntry.ulTimestamp = Aom_Time_GetCurrentTime()->ulTicks;
+    sEntry.ucOutputIdx = FAULT_LOG_CLEAR_MARKER | FAULT_LOG_NO_OUTPUT;
+
+    /* Don't count the marker itself as lost fault */
+    const u16 uiLostBefore = uiLostCount;
+    bClearPending = (AddEntry(&sEntry) == false);
+    uiLostCount = uiLostBefore;
+
+    FaultLog_Flush();
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Moves the full head row into the full row for the write. The next
+            row of the ring gets the head row. Its oldest entries are dropped.
+\return     none
+\param      none
+***********************************************************************************/
+static void RetireHeadRow(void)
+{
+    memcpy(sFullRow, sHeadRow, sizeof(sFullRow));
+    ucFullRow = ucHeadRow;
+    bFullRowPending = true;
+
+    ucHeadRow = (ucHeadRow + 1) % FAULT_LOG_ROWS;
+    ucRowEntries = 0;
+    ucWrittenEntries = 0;
+    memset(sHeadRow, 0, sizeof(sHeadRow));
+
+    if(bWriteRunning == false)
+    {
+        ucRetries = 0;
+    }
+    FaultLog_StartPendingWrite();
+}
+
+/****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Searches the newest entry and continues the ring behind it.
+\return     none
+\param      none
+***********************************************************************************/
+void FaultLog_Init(void)
+{
+    tsFaultLogEntry sEntry;
+    bool bFound = false;
+    u16 uiNewestSlot = 0;
+    u16 uiNewestSequence = 0;
+
+    u16 uiSlot;
+    for(uiSlot = 0; uiSlot < FAULT_LOG_ENTRIES; uiSlot++)
+    {
+        if(ReadFlashEntry(uiSlot, &sEntry))
+        {
+            if(bFound == false || IsNewer(sEntry.uiSequence, uiNewestSequence))
+            {
+                uiNewestSequence = sEntry.uiSequence;
+                uiNewestSlot = uiSlot;
+                bFound = true;
+            }
+        }
+    }
+
+    memset(sHeadRow, 0, sizeof(sHeadRow));
+    ucHeadRow = 0;
+    ucRowEntries = 0;
+    bFullRowPending = false;
+    bClearPending = false;
+
+    if(bFound)
+    {
+        const u16 uiHeadSlot = (uiNewestSlot + 1) % FAULT_LOG_ENTRIES;
+
+        uiNextSequence = uiNewestSequence + 1;
+        ucHeadRow = uiHeadSlot / FAULT_LOG_ENTRIES_PER_ROW;
+
+        /* Take over the entries of the head row for the next write */
+        u8 ucRowSlot;
+        for(ucRowSlot = 0; ucRowSlot < uiHeadSlot % FAULT_LOG_ENTRIES_PER_ROW; ucRowSlot++)
+        {
+            ReadFlashEntry((ucHeadRow * FAULT_LOG_ENTRIES_PER_ROW) + ucRowSlot, &sHeadRow[ucRowSlot]);
+            ucRowEntries++;
+        }
+    }
+
+    ucWrittenEntries = ucRowEntries;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Adds a set fault with the RTC time and the values of its output.
+\return     none
+\param      eFault - The set fault
+***********************************************************************************/
+void FaultLog_Record(teErrorList eFault)
+{
+    tsFaultLogEntry sEntry;
+    memset(&sEntry, 0, sizeof(sEntry));
+
+    sEntry.ulTimestamp = Aom_Time_GetCurrentTime()->ulTicks;
+    sEntry.uiFaultCode = GetFaultCode(eFault);
+    sEntry.ucOutputIdx = GetOutputIdx(eFault);
+
+    if(sEntry.ucOutputIdx < DRIVE_OUTPUTS)
+    {
+        const tRegulationValues* psRegVal = Aom_GetRegulationSettings();
+
+        sEntry.uiVoltageAdc = psRegVal->sLedValue[sEntry.ucOutputIdx].uiIsVoltageAdc;
+        sEntry.uiCurrentAdc = psRegVal->sLedValue[sEntry.ucOutputIdx].uiIsCurrentAdc;
+        sEntry.uiNtcAdc = psRegVal->uiNtcAdcValue[sEntry.ucOutputIdx];
+    }
+
+    AddEntry(&sEntry);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Hides all entries by writing a clear marker. The entries are hidden
+            at once even when the marker has to wait for space.
+\return     none
+\param      none
+***********************************************************************************/
+void FaultLog_Clear(void)
+{
+    uiLostCount = 0;
+    AddClearMarker();
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Writes the unwritten entries when the oldest one has waited for
+            FAULT_LOG_FLUSH_DELAY_MS. Is called periodically.
+\return     none
+\param      none
+***********************************************************************************/
+void FaultLog_Tick(void)
+{
+    if(ucRowEntries > ucWrittenEntries && bFlushRequested == false && bWriteRunning == false
+        && (DR_System_GetTickMs() - ulFirstPendingTick) >= FAULT_LOG_FLUSH_DELAY_MS)
+    {
+        FaultLog_Flush();
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Requests the write of the head row when it contains unwritten
+            entries. When the flash is busy the write is started after the
+            running job.
+\return     none
+\param      none
+***********************************************************************************/
+void FaultLog_Flush(void)
+{
+    if(ucRowEntries > ucWrittenEntries || bFullRowPending)
+    {
+        bFlushRequested = true;
+        ucRetries = 0;
+
+        FaultLog_StartPendingWrite();
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Starts the write of the full row or a requested write of the head
+            row. The full row is written first.
+\return     bool - True when the write was started
+\param      none
+***********************************************************************************/
+bool FaultLog_StartPendingWrite(void)
+{
+    if(bWriteRunning)
+    {
+        return false;
+    }
+
+    if(bFullRowPending)
+    {
+        if(DR_Flash_StartWrite(eFlashJob_FaultLog, FLASH_ROW_OF(ucFaultLogFlash) + ucFullRow, sFullRow, sizeof(sFullRow)))
+        {
+            ucWriteRow = ucFullRow;
+            bWritingFullRow = true;
+            bWriteRunning = true;
+        }
+    }
+    else if(bFlushRequested && ucRowEntries > ucWrittenEntries)
+    {
+        if(DR_Flash_StartWrite(eFlashJob_FaultLog, FLASH_ROW_OF(ucFaultLogFlash) + ucHeadRow, sHeadRow, sizeof(sHeadRow)))
+        {
+            ucWriteEntries = ucRowEntries;
+            ucWriteRow = ucHeadRow;
+            bWritingFullRow = false;
+            bFlushRequested = false;
+            bWriteRunning = true;
+        }
+    }
+    else
+    {
+        bFlushRequested = false;
+    }
+
+    return bWriteRunning;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Takes over the written entries. After the write of the full row a
+            full head row is moved for the next write and a waiting clear
+            marker is added.
+\return     none
+\param      bSuccess - True when the row was programmed and verified
+***********************************************************************************/
+void FaultLog_WriteDone(bool bSuccess)
+{
+    bWriteRunning = false;
+
+    if(bSuccess || ucRetries >= FLASH_WRITE_RETRIES)
+    {
+        ucRetries = 0;
+
+        if(bWritingFullRow)
+        {
+            /* A failed row is dropped to keep the log running */
+            bFullRowPending = false;
+
+            if(ucRowEntries >= FAULT_LOG_ENTRIES_PER_ROW)
+            {
+                RetireHeadRow();
+            }
+
+            if(bClearPending)
+            {
+                AddClearMarker();
+            }
+        }
+        else if(bSuccess && ucWriteRow == ucHeadRow)
+        {
+            /* The head row may have been moved during the write */
+            ucWrittenEntries = ucWriteEntries;
+        }
+    }
+    else
+    {
+        ucRetries++;
+        bFlushRequested = true;
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the amount of entries behind the last clear. A clear
+            marker which was overwritten by the ring hides nothing anymore.
+\return     u16 - The entry count
+\param      none
+***********************************************************************************/
+u16 FaultLog_GetEntryCount(void)
+{
+    const u16 uiHeadSlot = (ucHeadRow * FAULT_LOG_ENTRIES_PER_ROW) + ucRowEntries;
+    tsFaultLogEntry sEntry;
+    u16 uiCount = 0;
+
+    if(bClearPending)
+    {
+        return 0;
+    }
+
+    /* Go back from the newest entry until the sequence breaks or the clear marker is reached */
+    while(uiCount < FAULT_LOG_ENTRIES)
+    {
+        const u16 uiSequence = uiNextSequence - 1 - uiCount;
+        const u16 uiSlot = (uiHeadSlot + FAULT_LOG_ENTRIES - 1 - uiCount) % FAULT_LOG_ENTRIES;
+
+        if(ReadEntry(uiSlot, &sEntry) == false
+            || sEntry.uiSequence != uiSequence
+            || (sEntry.ucOutputIdx & FAULT_LOG_CLEAR_MARKER))
+        {
+            break;
+        }
+
+        uiCount++;
+    }
+
+    return uiCount;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns an entry of the log. Index zero is the oldest entry.
+\return     bool - True when the entry exists
+\param      uiEntryIdx - Index of the entry
+\param      psEntry - Pointer to the entry which shall be filled
+***********************************************************************************/
+bool FaultLog_GetEntry(u16 uiEntryIdx, tsFaultLogEntry* psEntry)
+{
+    const u16 uiCount = FaultLog_GetEntryCount();
+
+    if(uiEntryIdx >= uiCount)
+    {
+        return false;
+    }
+
+    const u16 uiHeadSlot = (ucHeadRow * FAULT_LOG_ENTRIES_PER_ROW) + ucRowEntries;
+    const u16 uiSlot = (uiHeadSlot + FAULT_LOG_ENTRIES - uiCount + uiEntryIdx) % FAULT_LOG_ENTRIES;
+
+    return ReadEntry(uiSlot, psEntry);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the faults which were lost since the last clear or start
+            because the head row and the full row were both waiting for the
+            write.
+\return     uiLostCount - The lost faults
+\param      none
+***********************************************************************************/
+u16 FaultLog_GetLostCount(void)
+{
+    return uiLostCount;
+}
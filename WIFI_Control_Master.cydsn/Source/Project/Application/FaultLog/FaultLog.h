@@ -0,0 +1,59 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       FaultLog.h
+\brief      Ring of the set faults in the flash. The faults are collected in
+            the RAM and written row wise, so the flash is written rarely.
+
+***********************************************************************************/
+#ifndef _FAULTLOG_H_
+#define _FAULTLOG_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "OS_Faults.h"
+
+/***************************** defines / macros ******************************/
+#define FAULT_LOG_NO_OUTPUT     0x7F    //Output index of the faults which don't belong to an output
+
+/****************************** type definitions *****************************/
+typedef struct
+{
+    u32 ulTimestamp;    //RTC time of the fault
+    u16 uiSequence;     //Incremented with each entry. The newest entry has the highest number
+    u16 uiFaultCode;    //Fault code of the USER_ERROR_LIST. OS faults use their ID
+    u16 uiVoltageAdc;   //Snapshot of the output when the fault was set
+    u16 uiCurrentAdc;
+    u16 uiNtcAdc;
+    u8  ucOutputIdx;    //Bit 7 marks a clear of the log
+    u8  ucCheck;        //Inverted sum of the other bytes
+}tsFaultLogEntry;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    FaultLog_Init(void);
+void    FaultLog_Record(teErrorList eFault);
+void    FaultLog_Clear(void);
+void    FaultLog_Tick(void);
+void    FaultLog_Flush(void);
+bool    FaultLog_StartPendingWrite(void);
+void    FaultLog_WriteDone(bool bSuccess);
+
+u16     FaultLog_GetEntryCount(void);
+bool    FaultLog_GetEntry(u16 uiEntryIdx, tsFaultLogEntry* psEntry);
+u16     FaultLog_GetLostCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_FAULTLOG_H_
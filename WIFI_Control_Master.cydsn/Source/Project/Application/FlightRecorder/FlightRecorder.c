@@ -0,0 +1,227 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       FlightRecorder.c
+\brief      The dispatched events, state requests and faults are logged with a
+            time stamp into a ring buffer in the no-init RAM. The buffer isn't
+            cleared by the start-up code and therefore survives a watchdog or
+            software reset. On start-up the log of the previous boot is copied
+            and can be read over UART afterwards.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "OS_Config.h"
+#include "FlightRecorder.h"
+#include "DR_System.h"
+
+/****************************************** Defines ******************************************************/
+#define FLIGHT_REC_MAGIC        0x46524543u     //"FREC"
+
+typedef struct
+{
+    u32 ulMagic;
+    u32 ulMagicInv;                             //Inverted magic. Detects random content after a power-on
+    u16 uiBootCount;
+    u16 uiWriteIdx;
+    u16 uiCount;
+    tsFlightRecEntry sEntries[FLIGHT_REC_ENTRIES];
+}tsFlightRecLog;
+
+/****************************************** Variables ****************************************************/
+static tsFlightRecLog sLog CY_NOINIT;       //Log of the running boot
+static tsFlightRecLog sPreviousLog;         //Copy of the log before the last reset
+static u32 ulResetReason = 0;
+
+/****************************************** Function prototypes ******************************************/
+static bool IsLogValid(const tsFlightRecLog* psLog);
+static const tsFlightRecLog* GetLog(bool bPreviousBoot);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Checks the log header for a valid content
+\return     bool - True when the log contains valid entries
+\param      psLog - The log which shall be checked
+***********************************************************************************/
+static bool IsLogValid(const tsFlightRecLog* psLog)
+{
+    return (psLog->ulMagic == FLIGHT_REC_MAGIC
+            && psLog->ulMagicInv == ~FLIGHT_REC_MAGIC
+            && psLog->uiWriteIdx < FLIGHT_REC_ENTRIES
+            && psLog->uiCount <= FLIGHT_REC_ENTRIES);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the log of the running or the previous boot
+\return     psLog - Pointer to the log
+\param      bPreviousBoot - True for the log before the last reset
+***********************************************************************************/
+static const tsFlightRecLog* GetLog(bool bPreviousBoot)
+{
+    return bPreviousBoot ? &sPreviousLog : &sLog;
+}
+
+/****************************************** External visible functiones **********************************/
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Copies the log of the previous boot when it is valid and starts a
+            new log with the reset reason as first entry. Has to be called
+            after the time base was started.
+\return     none
+\param      none
+***********************************************************************************/
+void FlightRecorder_Init(void)
+{
+    /* Read and clear the reset reason */
+    ulResetReason = CySysGetResetReason(CY_SYS_RESET_WDT | CY_SYS_RESET_PROTFAULT | CY_SYS_RESET_SW);
+
+    u16 uiBootCount = 0;
+
+    if(IsLogValid(&sLog))
+    {
+        memcpy(&sPreviousLog, &sLog, sizeof(sPreviousLog));
+        uiBootCount = sLog.uiBootCount + 1;
+    }
+    else
+    {
+        /* Power-on or corrupted log. Nothing to keep */
+        memset(&sPreviousLog, 0, sizeof(sPreviousLog));
+    }
+
+    memset(&sLog, 0, sizeof(sLog));
+    sLog.ulMagic = FLIGHT_REC_MAGIC;
+    sLog.ulMagicInv = ~FLIGHT_REC_MAGIC;
+    sLog.uiBootCount = uiBootCount;
+
+    FlightRecorder_Record(eFlightRec_Reset, 0, uiBootCount, ulResetReason);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Writes a new entry into the log. The oldest entry is overwritten
+            when the log is full.
+\return     none
+\param      eType - Type of the entry
+\param      ucId - Event ID or fault code
+\param      uiParam1 - First parameter of the entry
+\param      ulParam2 - Second parameter of the entry
+***********************************************************************************/
+void FlightRecorder_Record(teFlightRecType eType, u8 ucId, u16 uiParam1, u32 ulParam2)
+{
+    const u8 ucCriticalSection = EnterCritical();
+
+    tsFlightRecEntry* psEntry = &sLog.sEntries[sLog.uiWriteIdx];
+    psEntry->ulTimestamp = DR_System_GetTickMs();
+    psEntry->ulParam2 = ulParam2;
+    psEntry->uiParam1 = uiParam1;
+    psEntry->ucType = (u8)eType;
+    psEntry->ucId = ucId;
+
+    if(++sLog.uiWriteIdx >= FLIGHT_REC_ENTRIES)
+    {
+        sLog.uiWriteIdx = 0;
+    }
+
+    if(sLog.uiCount < FLIGHT_REC_ENTRIES)
+    {
+        sLog.uiCount++;
+    }
+
+    LeaveCritical(ucCriticalSection);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the amount of logged entries
+\return     uiCount - Amount of entries in the log
+\param      bPreviousBoot - True for the log before the last reset
+***********************************************************************************/
+u16 FlightRecorder_GetEntryCount(bool bPreviousBoot)
+{
+    return GetLog(bPreviousBoot)->uiCount;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Copies an entry of the log. Index zero is the oldest entry.
+\return     bool - False when the index isn't available
+\param      bPreviousBoot - True for the log before the last reset
+\param      uiEntryIdx - Index of the entry, beginning with the oldest one
+\param      psEntry - Pointer to the entry which shall be filled
+***********************************************************************************/
+bool FlightRecorder_GetEntry(bool bPreviousBoot, u16 uiEntryIdx, tsFlightRecEntry* psEntry)
+{
+    const tsFlightRecLog* psLog = GetLog(bPreviousBoot);
+
+    if(uiEntryIdx >= psLog->uiCount)
+    {
+        return false;
+    }
+
+    /* The oldest entry is at the write index when the log is full */
+    u16 uiReadIdx = uiEntryIdx;
+    if(psLog->uiCount == FLIGHT_REC_ENTRIES)
+    {
+        uiReadIdx += psLog->uiWriteIdx;
+        if(uiReadIdx >= FLIGHT_REC_ENTRIES)
+        {
+            uiReadIdx -= FLIGHT_REC_ENTRIES;
+        }
+    }
+
+    const u8 ucCriticalSection = EnterCritical();
+    *psEntry = psLog->sEntries[uiReadIdx];
+    LeaveCritical(ucCriticalSection);
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the reset reason which was read on start-up.
+\return     ulResetReason - CY_SYS_RESET_... flags. Zero for a power-on or XRES
+\param      none
+***********************************************************************************/
+u32 FlightRecorder_GetResetReason(void)
+{
+    return ulResetReason;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the amount of resets since the last power-on
+\return     uiBootCount - Resets with a preserved log
+\param      none
+***********************************************************************************/
+u16 FlightRecorder_GetBootCount(void)
+{
+    return sLog.uiBootCount;
+}
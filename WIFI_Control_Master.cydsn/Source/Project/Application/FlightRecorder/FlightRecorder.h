@@ -0,0 +1,58 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       FlightRecorder.h
+\brief      Circular log of the last events and faults which survives a reset
+
+***********************************************************************************/
+#ifndef _FLIGHTRECORDER_H_
+#define _FLIGHTRECORDER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+
+/***************************** defines / macros ******************************/
+
+/****************************** type definitions *****************************/
+typedef enum
+{
+    eFlightRec_Reset,           /**< Param2: Reset reason of the boot */
+    eFlightRec_Event,           /**< Id: Dispatched event with its parameters */
+    eFlightRec_StateRequest,    /**< Param1: Requested state */
+    eFlightRec_NotProcessed,    /**< Id: Event which wasn't processed by any state */
+    eFlightRec_Fault            /**< Id: Fault code, Param1: True when set, false when cleared */
+}teFlightRecType;
+
+typedef struct
+{
+    u32 ulTimestamp;    //Millisecond tick since the boot
+    u32 ulParam2;
+    u16 uiParam1;
+    u8  ucType;         //See teFlightRecType
+    u8  ucId;
+}tsFlightRecEntry;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    FlightRecorder_Init(void);
+void    FlightRecorder_Record(teFlightRecType eType, u8 ucId, u16 uiParam1, u32 ulParam2);
+
+u16     FlightRecorder_GetEntryCount(bool bPreviousBoot);
+bool    FlightRecorder_GetEntry(bool bPreviousBoot, u16 uiEntryIdx, tsFlightRecEntry* psEntry);
+u32     FlightRecorder_GetResetReason(void);
+u16     FlightRecorder_GetBootCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_FLIGHTRECORDER_H_
@@ -0,0 +1,481 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       Occupancy.c
+\brief      Learns the gaps between the end of a motion and the start of the
+            next one. Each hour of the day has a histogram of the gaps in
+            buckets up to OCCUPANCY_RETURN_MIN. A full bucket halves all
+            buckets of the hour, so old gaps lose their weight.
+            A gap behind the burn time switches the light off and on again.
+            The burn time of an hour is the shortest bucket limit where these
+            cycles stay below OCCUPANCY_CYCLE_TARGET percent of the gaps.
+            The histogram is checkpointed into an own flash area after
+            OCCUPANCY_CHECKPOINT_GAPS new gaps.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "OS_Config.h"
+#include "DR_Flash.h"
+#include "Aom_Flash.h"
+#include "Aom_Measure.h"
+#include "Aom_Time.h"
+#include "Occupancy.h"
+
+/****************************************** Defines ******************************************************/
+#define OCCUPANCY_MAGIC         0x0C
+#define OCCUPANCY_VERSION       2       //Version 2: The adaptive flag is covered by the CRC
+#define OCCUPANCY_ROWS          ((sizeof(tsOccupancyImage) + CY_FLASH_SIZEOF_ROW - 1) / CY_FLASH_SIZEOF_ROW)
+#define GAP_BUCKETS             9       //The last bucket holds the gaps behind OCCUPANCY_RETURN_MIN
+#define STATISTIC_SUM_MAX       ((s32)0x7FFFFFFF)
+#define STATISTIC_SUM_MIN       (-STATISTIC_SUM_MAX - 1)
+
+typedef struct
+{
+    u8  aaucHistogram[OCCUPANCY_HOURS][GAP_BUCKETS];
+    tsOccupancyStatistic sStatistic;
+    u8  ucAdaptive;                             //1 = The learned burn time is used
+}tsOccupancyData;
+
+typedef struct
+{
+    u8  ucMagic;
+    u8  ucVersion;
+    u8  ucReserved[2];
+    u32 ulCrc;                                  //CRC over the data
+    tsOccupancyData sData;
+}tsOccupancyImage;
+
+/****************************************** Variables ****************************************************/
+/* Upper limit of each bucket in minutes. The burn time is one of these limits */
+static const u8 ucBucketLimitMin[GAP_BUCKETS - 1] = {1, 2, 3, 5, 8, 12, 20, OCCUPANCY_RETURN_MIN};
+
+/* Row aligned flash area of the histogram. Is read volatile because the content is changed by the flash writes */
+static const volatile u8 ucOccupancyFlash[OCCUPANCY_ROWS * CY_FLASH_SIZEOF_ROW] CY_ALIGN(CY_FLASH_SIZEOF_ROW) = {0};
+
+static tsOccupancyImage sImage;
+
+static bool bLastMotionLevel = false;
+static u32  ulLastMotionEndTick = 0;            //Time of the last motion end in seconds. Zero when unknown
+static u8   ucLastMotionEndHour = 0;
+static u16  uiUsedBurnTimeSec = 0;              //Burn time which was started with the last motion
+static u32  ulOnPowerMw = 0;                    //Power of the outputs when the light was on the last time
+static u8   ucNewGaps = 0;                      //Gaps since the last checkpoint
+
+static bool bWritePending = false;
+static bool bWriteRunning = false;
+static u8   ucRetries = 0;
+
+/****************************************** Function prototypes ******************************************/
+static u8   GetGapBucket(u32 ulGapSec);
+static void AddSaturated(s32* pslSum, s32 slValue);
+static u32  GetOutputPowerMw(void);
+static void RecordGap(u8 ucHour, u32 ulGapSec, u8 ucConfiguredBurnTime);
+static void RequestWrite(void);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Searches the bucket of a gap.
+\return     u8 - Index of the bucket
+\param      ulGapSec - The gap in seconds
+***********************************************************************************/
+static u8 GetGapBucket(u32 ulGapSec)
+{
+    u8 ucBucket = 0;
+
+    while(ucBucket < GAP_BUCKETS - 1 && ulGapSec > (u32)ucBucketLimitMin[ucBucket] * 60)
+    {
+        ucBucket++;
+    }
+
+    return ucBucket;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Adds a value to a sum of the statistic. The sum stays at its
+            limit instead of wrapping around.
+\return     none
+\param      pslSum - Pointer to the sum
+\param      slValue - The value which is added
+***********************************************************************************/
+static void AddSaturated(s32* pslSum, s32 slValue)
+{
+    if(slValue > 0 && *pslSum > STATISTIC_SUM_MAX - slValue)
+    {
+        *pslSum = STATISTIC_SUM_MAX;
+    }
+    else if(slValue < 0 && *pslSum < STATISTIC_SUM_MIN - slValue)
+    {
+        *pslSum = STATISTIC_SUM_MIN;
+    }
+    else
+    {
+        *pslSum += slValue;
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Sums up the measured power of all outputs.
+\return     u32 - The power in milliwatt
+\param      none
+***********************************************************************************/
+static u32 GetOutputPowerMw(void)
+{
+    u32 ulPowerMw = 0;
+
+    u8 ucOutputIdx;
+    for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
+    {
+        u32 ulMilliVolt = 0;
+        u16 uiMilliAmp = 0;
+
+        Aom_Measure_GetMeasuredValues(&ulMilliVolt, &uiMilliAmp, NULL, ucOutputIdx);
+        ulPowerMw += (ulMilliVolt * uiMilliAmp) / 1000;
+    }
+
+    return ulPowerMw;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Puts a gap into the histogram of the hour and compares the on-time
+            of the used burn time with the configured one.
+\return     none
+\param      ucHour - The hour of the motion end
+\param      ulGapSec - The gap until the next motion in seconds
+\param      ucConfiguredBurnTime - The configured burn time in minutes
+***********************************************************************************/
+static void RecordGap(u8 ucHour, u32 ulGapSec, u8 ucConfiguredBurnTime)
+{
+    u8* pucHistogram = sImage.sData.aaucHistogram[ucHour];
+    tsOccupancyStatistic* psStatistic = &sImage.sData.sStatistic;
+    const u8 ucBucket = GetGapBucket(ulGapSec);
+
+    /* Age the hour before the bucket overflows */
+    if(pucHistogram[ucBucket] == 0xFF)
+    {
+        u8 ucBucketIdx;
+        for(ucBucketIdx = 0; ucBucketIdx < GAP_BUCKETS; ucBucketIdx++)
+        {
+            pucHistogram[ucBucketIdx] >>= 1;
+        }
+    }
+    pucHistogram[ucBucket]++;
+
+    /* The light burns until the next motion or until the burn time expires */
+    const u32 ulFixedBurnSec = (u32)ucConfiguredBurnTime * 60;
+    const u32 ulFixedOnSec = (ulGapSec < ulFixedBurnSec) ? ulGapSec : ulFixedBurnSec;
+    const u32 ulUsedOnSec = (ulGapSec < uiUsedBurnTimeSec) ? ulGapSec : uiUsedBurnTimeSec;
+    const s32 slSavedSec = (s32)ulFixedOnSec - (s32)ulUsedOnSec;
+
+    /* Split the power into watt and milliwatt. The product of the saved seconds and the milliwatt would overflow */
+    const s32 slPowerW = (s32)(ulOnPowerMw / 1000);
+    const s32 slPowerRestMw = (s32)(ulOnPowerMw % 1000);
+
+    AddSaturated(&psStatistic->slSavedOnTimeSec, slSavedSec);
+    AddSaturated(&psStatistic->slSavedEnergyWs, (slSavedSec * slPowerW) + ((slSavedSec * slPowerRestMw) / 1000));
+    psStatistic->ulGapCount++;
+
+    if(ulGapSec <= (u32)OCCUPANCY_RETURN_MIN * 60)
+    {
+        if(ulGapSec > uiUsedBurnTimeSec && psStatistic->uiCycles < 0xFFFF)
+        {
+            psStatistic->uiCycles++;
+        }
+
+        if(ulGapSec > ulFixedBurnSec && psStatistic->uiFixedCycles < 0xFFFF)
+        {
+            psStatistic->uiFixedCycles++;
+        }
+    }
+
+    if(++ucNewGaps >= OCCUPANCY_CHECKPOINT_GAPS)
+    {
+        RequestWrite();
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the CRC and requests the write into the flash.
+\return     none
+\param      none
+***********************************************************************************/
+static void RequestWrite(void)
+{
+    sImage.ulCrc = Aom_Flash_CalculateCrc(&sImage.sData, sizeof(sImage.sData));
+
+    ucNewGaps = 0;
+    bWritePending = true;
+    ucRetries = 0;
+    Occupancy_StartPendingWrite();
+}
+
+/****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads the histogram from the flash. An invalid histogram is
+            replaced by an empty one.
+\return     none
+\param      none
+***********************************************************************************/
+void Occupancy_Init(void)
+{
+    u8* pucImage = (u8*)&sImage;
+
+    u16 uiByteIdx;
+    for(uiByteIdx = 0; uiByteIdx < sizeof(sImage); uiByteIdx++)
+    {
+        pucImage[uiByteIdx] = ucOccupancyFlash[uiByteIdx];
+    }
+
+    if(sImage.ucMagic != OCCUPANCY_MAGIC
+        || sImage.ucVersion != OCCUPANCY_VERSION
+        || sImage.ulCrc != Aom_Flash_CalculateCrc(&sImage.sData, sizeof(sImage.sData)))
+    {
+        memset(&sImage, 0, sizeof(sImage));
+        sImage.ucMagic = OCCUPANCY_MAGIC;
+        sImage.ucVersion = OCCUPANCY_VERSION;
+        sImage.sData.ucAdaptive = OCCUPANCY_ADAPTIVE_DEFAULT;
+        sImage.ulCrc = Aom_Flash_CalculateCrc(&sImage.sData, sizeof(sImage.sData));
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Learns the gap when a motion starts and selects the burn time
+            which is started with this motion. Nothing is learned without a
+            received time.
+\return     u8 - The burn time in minutes
+\param      bMotionLevel - True while the PIR detects a motion
+\param      ucConfiguredBurnTime - The configured burn time in minutes
+***********************************************************************************/
+u8 Occupancy_MotionChanged(bool bMotionLevel, u8 ucConfiguredBurnTime)
+{
+    const tsCurrentTime* psTime = Aom_Time_GetCurrentTime();
+    const bool bTimeValid = (psTime->ulTicks != 0 && psTime->ucHours < OCCUPANCY_HOURS);
+
+    /* A motion starts when the last call ended the motion. A short motion has already ended again */
+    if(bTimeValid && bLastMotionLevel == false
+        && ulLastMotionEndTick != 0 && psTime->ulTicks >= ulLastMotionEndTick)
+    {
+        RecordGap(ucLastMotionEndHour, psTime->ulTicks - ulLastMotionEndTick, ucConfiguredBurnTime);
+    }
+
+    if(bMotionLevel == false)
+    {
+        ulLastMotionEndTick = bTimeValid ? psTime->ulTicks : 0;
+        ucLastMotionEndHour = psTime->ucHours;
+    }
+
+    bLastMotionLevel = bMotionLevel;
+
+    /* Keep the power of the light for the energy of the saved on-time */
+    const u32 ulPowerMw = GetOutputPowerMw();
+    if(ulPowerMw)
+    {
+        ulOnPowerMw = ulPowerMw;
+    }
+
+    const u8 ucBurnTime = Occupancy_GetBurnTime(bTimeValid ? psTime->ucHours : OCCUPANCY_HOURS, ucConfiguredBurnTime);
+    uiUsedBurnTimeSec = (u16)ucBurnTime * 60;
+
+    return ucBurnTime;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Selects the shortest burn time of the hour where the light is
+            switched off and on again in less than OCCUPANCY_CYCLE_TARGET
+            percent of the gaps. The configured burn time is used until the
+            hour has OCCUPANCY_MIN_GAPS gaps.
+\return     u8 - The burn time in minutes
+\param      ucHour - The hour of the day
+\param      ucConfiguredBurnTime - The configured burn time in minutes
+***********************************************************************************/
+u8 Occupancy_GetBurnTime(u8 ucHour, u8 ucConfiguredBurnTime)
+{
+    if(sImage.sData.ucAdaptive == false || ucHour >= OCCUPANCY_HOURS)
+    {
+        return ucConfiguredBurnTime;
+    }
+
+    const u8* pucHistogram = sImage.sData.aaucHistogram[ucHour];
+    u16 uiTotal = 0;
+    u16 uiCycles = 0;
+
+    u8 ucBucketIdx;
+    for(ucBucketIdx = 0; ucBucketIdx < GAP_BUCKETS; ucBucketIdx++)
+    {
+        uiTotal += pucHistogram[ucBucketIdx];
+
+        /* Gaps behind the first limit until a return into the room */
+        if(ucBucketIdx > 0 && ucBucketIdx < GAP_BUCKETS - 1)
+        {
+            uiCycles += pucHistogram[ucBucketIdx];
+        }
+    }
+
+    if(uiTotal < OCCUPANCY_MIN_GAPS)
+    {
+        return ucConfiguredBurnTime;
+    }
+
+    /* A longer burn time removes the cycles of the next bucket */
+    for(ucBucketIdx = 0; ucBucketIdx < GAP_BUCKETS - 2; ucBucketIdx++)
+    {
+        if((u32)uiCycles * 100 <= (u32)uiTotal * OCCUPANCY_CYCLE_TARGET)
+        {
+            break;
+        }
+
+        uiCycles -= pucHistogram[ucBucketIdx + 1];
+    }
+
+    return ucBucketLimitMin[ucBucketIdx];
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the saved on-time and energy since the last reset.
+\return     tsOccupancyStatistic - Pointer to the statistic
+\param      none
+***********************************************************************************/
+const tsOccupancyStatistic* Occupancy_GetStatistic(void)
+{
+    return &sImage.sData.sStatistic;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns if the learned burn time is used.
+\return     bool - True when the burn time is adaptive
+\param      none
+***********************************************************************************/
+bool Occupancy_GetAdaptiveStatus(void)
+{
+    return (sImage.sData.ucAdaptive != 0);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Switches between the learned and the configured burn time. The
+            gaps are learned in both cases.
+\return     none
+\param      bAdaptive - True when the learned burn time shall be used
+***********************************************************************************/
+void Occupancy_SetAdaptiveStatus(bool bAdaptive)
+{
+    if(sImage.sData.ucAdaptive != (u8)bAdaptive)
+    {
+        sImage.sData.ucAdaptive = bAdaptive;
+        RequestWrite();
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Clears the learned gaps and the statistic. The adaptive flag is
+            kept.
+\return     none
+\param      none
+***********************************************************************************/
+void Occupancy_Reset(void)
+{
+    const u8 ucAdaptive = sImage.sData.ucAdaptive;
+
+    memset(&sImage.sData, 0, sizeof(sImage.sData));
+    sImage.sData.ucAdaptive = ucAdaptive;
+    ulLastMotionEndTick = 0;
+
+    RequestWrite();
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Starts a requested write of the histogram.
+\return     bool - True when the write was started
+\param      none
+***********************************************************************************/
+bool Occupancy_StartPendingWrite(void)
+{
+    if(bWritePending == false || bWriteRunning)
+    {
+        return false;
+    }
+
+    if(DR_Flash_StartWrite(eFlashJob_Occupancy, FLASH_ROW_OF(ucOccupancyFlash), &sImage, sizeof(sImage)))
+    {
+        bWritePending = false;
+        bWriteRunning = true;
+    }
+
+    return bWriteRunning;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Repeats a failed write of the histogram.
+\return     none
+\param      bSuccess - True when the rows were programmed and verified
+***********************************************************************************/
+void Occupancy_WriteDone(bool bSuccess)
+{
+    bWriteRunning = false;
+
+    if(bSuccess)
+    {
+        ucRetries = 0;
+    }
+    else if(ucRetries < FLASH_WRITE_RETRIES)
+    {
+        ucRetries++;
+        bWritePending = true;
+    }
+}
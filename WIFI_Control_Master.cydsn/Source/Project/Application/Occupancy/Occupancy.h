@@ -0,0 +1,56 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       Occupancy.h
+\brief      Learns the gaps between motions for each hour of the day and
+            selects the burn time of the motion detection.
+
+***********************************************************************************/
+#ifndef _OCCUPANCY_H_
+#define _OCCUPANCY_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "Project_Config.h"
+
+/***************************** defines / macros ******************************/
+#define OCCUPANCY_HOURS     24
+#define OCCUPANCY_RETURN_MIN 30     //A motion within this gap is a return into the room. Longer gaps are an empty room
+
+/****************************** type definitions *****************************/
+typedef struct
+{
+    s32 slSavedOnTimeSec;   //On-time which was saved against the configured burn time. Negative when the light burned longer
+    s32 slSavedEnergyWs;    //Saved on-time multiplied with the power of the outputs
+    u32 ulGapCount;         //Learned gaps since the last reset
+    u16 uiCycles;           //Light was switched off and on again by a motion within OCCUPANCY_RETURN_MIN
+    u16 uiFixedCycles;      //Same cycles with the configured burn time
+}tsOccupancyStatistic;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    Occupancy_Init(void);
+u8      Occupancy_MotionChanged(bool bMotionLevel, u8 ucConfiguredBurnTime);
+u8      Occupancy_GetBurnTime(u8 ucHour, u8 ucConfiguredBurnTime);
+const tsOccupancyStatistic* Occupancy_GetStatistic(void);
+bool    Occupancy_GetAdaptiveStatus(void);
+void    Occupancy_SetAdaptiveStatus(bool bAdaptive);
+void    Occupancy_Reset(void);
+
+bool    Occupancy_StartPendingWrite(void);
+void    Occupancy_WriteDone(bool bSuccess);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_OCCUPANCY_H_
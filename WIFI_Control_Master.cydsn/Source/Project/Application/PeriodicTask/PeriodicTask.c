@@ -0,0 +1,109 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       PeriodicTask.c
+\brief      Each state registers a table with one task per period of the
+            USER_PERIODIC_TASK_LIST. The software timer events are passed by the
+            main task directly to the registered task. Thus the ticks don't walk
+            through the main state and the state handlers.
+
+***********************************************************************************/
+#include "OS_Config.h"
+#include "PeriodicTask.h"
+
+/****************************************** Defines ******************************************************/
+
+/****************************************** Variables ****************************************************/
+static const pFunctionPeriodicTask* ppfnActiveTasks = NULL;
+
+/****************************************** Function prototypes ******************************************/
+static tePeriod GetPeriod(ulEventParam2 ulTimerEvent);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the period of the given software timer event.
+\return     tePeriod - The period or ePeriod_Max for an unknown timer
+\param      ulTimerEvent - Param2 of the software timer event
+***********************************************************************************/
+static tePeriod GetPeriod(ulEventParam2 ulTimerEvent)
+{
+    tePeriod ePeriod = ePeriod_Max;
+
+    switch(ulTimerEvent)
+    {
+        #define PERIOD(PeriodName, TimerEvent) case TimerEvent: ePeriod = PeriodName; break;
+            USER_PERIODIC_TASK_LIST
+        #undef PERIOD
+
+        default:
+            break;
+    }
+
+    return ePeriod;
+}
+
+/****************************************** External visible functiones **********************************/
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Registers the task table of a state. Should be called in the entry
+            function of the state.
+\return     none
+\param      ppfnTasks - Table with ePeriod_Max entries. Periods without a task
+                        are NULL.
+***********************************************************************************/
+void PeriodicTask_Register(const pFunctionPeriodicTask* ppfnTasks)
+{
+    ppfnActiveTasks = ppfnTasks;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Removes the registered task table. Should be called in the exit
+            function of the state.
+\return     none
+\param      none
+***********************************************************************************/
+void PeriodicTask_Unregister(void)
+{
+    ppfnActiveTasks = NULL;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calls the registered task of the software timer event.
+\return     bool - True when a task was called. Otherwise the event has to be
+                   dispatched to the states.
+\param      ulTimerEvent - Param2 of the software timer event
+***********************************************************************************/
+bool PeriodicTask_Dispatch(ulEventParam2 ulTimerEvent)
+{
+    if(ppfnActiveTasks == NULL)
+    {
+        return false;
+    }
+
+    const tePeriod ePeriod = GetPeriod(ulTimerEvent);
+
+    if(ePeriod == ePeriod_Max || ppfnActiveTasks[ePeriod] == NULL)
+    {
+        return false;
+    }
+
+    ppfnActiveTasks[ePeriod]();
+    return true;
+}
@@ -0,0 +1,47 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       PeriodicTask.h
+\brief      Registry of the periodic tasks of the current state
+
+***********************************************************************************/
+#ifndef _PERIODICTASK_H_
+#define _PERIODICTASK_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "OS_EventManager.h"
+
+/***************************** defines / macros ******************************/
+
+/****************************** type definitions *****************************/
+typedef enum
+{
+    #define PERIOD(PeriodName, TimerEvent) PeriodName,
+        USER_PERIODIC_TASK_LIST
+    #undef PERIOD
+    ePeriod_Max
+}tePeriod;
+
+typedef void (*pFunctionPeriodicTask)(void);
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    PeriodicTask_Register(const pFunctionPeriodicTask* ppfnTasks);
+void    PeriodicTask_Unregister(void);
+bool    PeriodicTask_Dispatch(ulEventParam2 ulTimerEvent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_PERIODICTASK_H_
@@ -0,0 +1,110 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       Profiler.c
+\brief      The execution times of the functions which are enclosed with
+            PROFILE_START and PROFILE_STOP are collected in a static table.
+            The time base is the free running cycle counter of the DR_System.
+            Without PROFILER_ENABLE the macros and this module are empty.
+
+***********************************************************************************/
+#include "OS_Config.h"
+#include "Profiler.h"
+
+#if PROFILER_ENABLE
+/****************************************** Defines ******************************************************/
+
+/****************************************** Variables ****************************************************/
+static tsProfileEntry sProfileTable[eProfile_Max];
+
+/****************************************** Function prototypes ******************************************/
+
+/****************************************** local functions *********************************************/
+
+/****************************************** External visible functiones **********************************/
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Adds a measurement to the entry of the function. Can be called from
+            an interrupt. A negative difference of the cycle counter (more than
+            one missed tick with masked interrupts) is dropped, so it doesn't
+            falsify the maximum and the average.
+\return     none
+\param      eProfileId - The instrumented function
+\param      ulCycles - Measured execution time in cycles
+***********************************************************************************/
+void Profiler_Record(teProfileId eProfileId, u32 ulCycles)
+{
+    if((s32)ulCycles < 0)
+    {
+        return;
+    }
+    
+    const u8 ucCriticalSection = EnterCritical();
+
+    tsProfileEntry* psEntry = &sProfileTable[eProfileId];
+
+    if(psEntry->ulCount == 0 || ulCycles < psEntry->ulMinCycles)
+    {
+        psEntry->ulMinCycles = ulCycles;
+    }
+
+    if(ulCycles > psEntry->ulMaxCycles)
+    {
+        psEntry->ulMaxCycles = ulCycles;
+    }
+
+    /* Stop the average before the sum overflows */
+    if(psEntry->ulSumCycles <= (0xFFFFFFFF - ulCycles))
+    {
+        psEntry->ulSumCycles += ulCycles;
+        psEntry->ulCount++;
+    }
+
+    LeaveCritical(ucCriticalSection);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Copies the entry of the function.
+\return     bool - False for an invalid profile ID
+\param      eProfileId - The instrumented function
+\param      psEntry - Pointer to the entry which shall be filled
+***********************************************************************************/
+bool Profiler_GetEntry(teProfileId eProfileId, tsProfileEntry* psEntry)
+{
+    if(eProfileId >= eProfile_Max)
+    {
+        return false;
+    }
+
+    const u8 ucCriticalSection = EnterCritical();
+    *psEntry = sProfileTable[eProfileId];
+    LeaveCritical(ucCriticalSection);
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Clears all entries.
+\return     none
+\param      none
+***********************************************************************************/
+void Profiler_Reset(void)
+{
+    const u8 ucCriticalSection = EnterCritical();
+    memset(sProfileTable, 0, sizeof(sProfileTable));
+    LeaveCritical(ucCriticalSection);
+}
+#endif //PROFILER_ENABLE
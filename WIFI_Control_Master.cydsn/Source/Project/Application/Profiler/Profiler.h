@@ -0,0 +1,64 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       Profiler.h
+\brief      Execution time measurement of the instrumented functions
+
+***********************************************************************************/
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "Project_Config.h"
+#include "DR_System.h"
+
+/***************************** defines / macros ******************************/
+#if PROFILER_ENABLE
+    /* Both macros have to be used in the same scope */
+    #define PROFILE_START(ProfileId)    const u32 ulProfileStart_##ProfileId = DR_System_GetCycleCount()
+    #define PROFILE_STOP(ProfileId)     Profiler_Record(ProfileId, DR_System_GetCycleCount() - ulProfileStart_##ProfileId)
+#else
+    #define PROFILE_START(ProfileId)
+    #define PROFILE_STOP(ProfileId)
+#endif
+
+/****************************** type definitions *****************************/
+typedef enum
+{
+    #define PROFILE(ProfileId) ProfileId,
+        USER_PROFILE_LIST
+    #undef PROFILE
+    eProfile_Max
+}teProfileId;
+
+typedef struct
+{
+    u32 ulCount;        //Amount of measurements
+    u32 ulSumCycles;    //Sum of the execution times. Used for the average
+    u32 ulMinCycles;
+    u32 ulMaxCycles;
+}tsProfileEntry;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+#if PROFILER_ENABLE
+void    Profiler_Record(teProfileId eProfileId, u32 ulCycles);
+bool    Profiler_GetEntry(teProfileId eProfileId, tsProfileEntry* psEntry);
+void    Profiler_Reset(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_PROFILER_H_
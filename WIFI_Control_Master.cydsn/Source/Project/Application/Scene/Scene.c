@@ -0,0 +1,274 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       Scene.c
+\brief      Scene presets in an own flash area. Each scene holds the status
+            and the brightness of all outputs and a fade time. A recall sets
+            all outputs at once, so they start to fade in the same regulation
+            cycle. A stored scene is written into the flash in the background.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "OS_Config.h"
+#include "DR_Flash.h"
+#include "Aom_Flash.h"
+#include "Aom_Regulation.h"
+#include "Scene.h"
+
+/****************************************** Defines ******************************************************/
+#define SCENE_MAGIC             0x5C
+#define SCENE_VERSION           1
+#define SCENE_ROWS              ((sizeof(tsSceneImage) + CY_FLASH_SIZEOF_ROW - 1) / CY_FLASH_SIZEOF_ROW)
+#define SCENE_OUTPUT_MASK       ((0x01 << DRIVE_OUTPUTS) - 1)
+
+typedef struct
+{
+    u8  ucMagic;
+    u8  ucVersion;
+    u8  ucSceneCount;
+    u8  ucReserved;
+    u32 ulCrc;                                  //CRC over the scenes
+    tsScene asScenes[SCENE_AMOUNT];
+}tsSceneImage;
+
+/****************************************** Variables ****************************************************/
+/* Row aligned flash area of the scenes. Is read volatile because the content is changed by the flash writes */
+static const volatile u8 ucSceneFlash[SCENE_ROWS * CY_FLASH_SIZEOF_ROW] CY_ALIGN(CY_FLASH_SIZEOF_ROW) = {0};
+
+static tsSceneImage sImage;                     //Used scenes. Is also the source of the flash write
+
+static bool bWritePending = false;
+static bool bWriteRunning = false;
+static u8   ucRetries = 0;
+
+/****************************************** Function prototypes ******************************************/
+static bool IsSceneValid(const tsScene* psScene);
+static bool IsSceneEqual(const tsScene* psSceneA, const tsScene* psSceneB);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Checks the ranges of a scene.
+\return     bool - True when the scene can be used
+\param      psScene - The scene
+***********************************************************************************/
+static bool IsSceneValid(const tsScene* psScene)
+{
+    if(psScene->ucOutputsOn & ~SCENE_OUTPUT_MASK)
+    {
+        return false;
+    }
+
+    u8 ucOutputIdx;
+    for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
+    {
+        if(psScene->aucBrightness[ucOutputIdx] < PERCENT_LOW || psScene->aucBrightness[ucOutputIdx] > PERCENT_HIGH)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Compares two scenes field by field. The padding bytes of the
+            structure are not defined and therefore not compared.
+\return     bool - True when both scenes have the same values
+\param      psSceneA - The first scene
+\param      psSceneB - The second scene
+***********************************************************************************/
+static bool IsSceneEqual(const tsScene* psSceneA, const tsScene* psSceneB)
+{
+    return (psSceneA->uiFadeTimeMs == psSceneB->uiFadeTimeMs
+            && psSceneA->ucOutputsOn == psSceneB->ucOutputsOn
+            && memcmp(psSceneA->aucBrightness, psSceneB->aucBrightness, DRIVE_OUTPUTS) == 0);
+}
+
+/****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads the scenes from the flash. Invalid scenes are replaced by
+            scenes which switch all outputs off.
+\return     none
+\param      none
+***********************************************************************************/
+void Scene_Init(void)
+{
+    u8* pucImage = (u8*)&sImage;
+
+    u16 uiByteIdx;
+    for(uiByteIdx = 0; uiByteIdx < sizeof(sImage); uiByteIdx++)
+    {
+        pucImage[uiByteIdx] = ucSceneFlash[uiByteIdx];
+    }
+
+    bool bValid = (sImage.ucMagic == SCENE_MAGIC
+                   && sImage.ucVersion == SCENE_VERSION
+                   && sImage.ucSceneCount == SCENE_AMOUNT
+                   && sImage.ulCrc == Aom_Flash_CalculateCrc(sImage.asScenes, sizeof(sImage.asScenes)));
+
+    u8 ucSceneIdx;
+    for(ucSceneIdx = 0; bValid && ucSceneIdx < SCENE_AMOUNT; ucSceneIdx++)
+    {
+        bValid = IsSceneValid(&sImage.asScenes[ucSceneIdx]);
+    }
+
+    if(bValid == false)
+    {
+        memset(&sImage, 0, sizeof(sImage));
+        sImage.ucMagic = SCENE_MAGIC;
+        sImage.ucVersion = SCENE_VERSION;
+        sImage.ucSceneCount = SCENE_AMOUNT;
+
+        for(ucSceneIdx = 0; ucSceneIdx < SCENE_AMOUNT; ucSceneIdx++)
+        {
+            memset(sImage.asScenes[ucSceneIdx].aucBrightness, PERCENT_LOW, DRIVE_OUTPUTS);
+        }
+
+        sImage.ulCrc = Aom_Flash_CalculateCrc(sImage.asScenes, sizeof(sImage.asScenes));
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Stores a scene and requests the write into the flash.
+\return     bool - False when the scene index or the scene is invalid
+\param      ucSceneIdx - Index of the scene
+\param      psScene - The new scene
+***********************************************************************************/
+bool Scene_Store(u8 ucSceneIdx, const tsScene* psScene)
+{
+    if(ucSceneIdx >= SCENE_AMOUNT || IsSceneValid(psScene) == false)
+    {
+        return false;
+    }
+
+    /* An unchanged scene doesn't need a flash write */
+    if(IsSceneEqual(&sImage.asScenes[ucSceneIdx], psScene))
+    {
+        return true;
+    }
+
+    /* Copy the fields only. The padding in the image stays as it is, so the CRC only changes with the values */
+    tsScene* psStored = &sImage.asScenes[ucSceneIdx];
+    psStored->uiFadeTimeMs = psScene->uiFadeTimeMs;
+    psStored->ucOutputsOn = psScene->ucOutputsOn;
+    memcpy(psStored->aucBrightness, psScene->aucBrightness, DRIVE_OUTPUTS);
+    sImage.ulCrc = Aom_Flash_CalculateCrc(sImage.asScenes, sizeof(sImage.asScenes));
+
+    bWritePending = true;
+    ucRetries = 0;
+    Scene_StartPendingWrite();
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Copies a stored scene.
+\return     bool - False when the scene doesn't exist
+\param      ucSceneIdx - Index of the scene
+\param      psScene - Pointer to the scene which shall be filled
+***********************************************************************************/
+bool Scene_Get(u8 ucSceneIdx, tsScene* psScene)
+{
+    if(ucSceneIdx >= SCENE_AMOUNT)
+    {
+        return false;
+    }
+
+    *psScene = sImage.asScenes[ucSceneIdx];
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Sets all outputs to the values of the scene. The outputs fade
+            together from their current values within the fade time.
+\return     bool - False when the scene doesn't exist
+\param      ucSceneIdx - Index of the scene
+***********************************************************************************/
+bool Scene_Recall(u8 ucSceneIdx)
+{
+    if(ucSceneIdx >= SCENE_AMOUNT)
+    {
+        return false;
+    }
+
+    const tsScene* psScene = &sImage.asScenes[ucSceneIdx];
+
+    Aom_Regulation_SetAllOutputs(psScene->aucBrightness, psScene->ucOutputsOn, psScene->uiFadeTimeMs);
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Starts a requested write of the scenes.
+\return     bool - True when the write was started
+\param      none
+***********************************************************************************/
+bool Scene_StartPendingWrite(void)
+{
+    if(bWritePending == false || bWriteRunning)
+    {
+        return false;
+    }
+
+    if(DR_Flash_StartWrite(eFlashJob_Scene, FLASH_ROW_OF(ucSceneFlash), &sImage, sizeof(sImage)))
+    {
+        bWritePending = false;
+        bWriteRunning = true;
+    }
+
+    return bWriteRunning;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Repeats a failed write of the scenes.
+\return     none
+\param      bSuccess - True when the row was programmed and verified
+***********************************************************************************/
+void Scene_WriteDone(bool bSuccess)
+{
+    bWriteRunning = false;
+
+    if(bSuccess)
+    {
+        ucRetries = 0;
+    }
+    else if(ucRetries < FLASH_WRITE_RETRIES)
+    {
+        ucRetries++;
+        bWritePending = true;
+    }
+}
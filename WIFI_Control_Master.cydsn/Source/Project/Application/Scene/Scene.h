@@ -0,0 +1,49 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       Scene.h
+\brief      Scene presets with the brightness and the status of all outputs and
+            a fade time. A scene is recalled with one message or infrared key.
+
+***********************************************************************************/
+#ifndef _SCENE_H_
+#define _SCENE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "Project_Config.h"
+
+/***************************** defines / macros ******************************/
+
+/****************************** type definitions *****************************/
+typedef struct
+{
+    u16 uiFadeTimeMs;                   //Time until the outputs reach the values of the scene
+    u8  ucOutputsOn;                    //Bit per output which is switched on
+    u8  aucBrightness[DRIVE_OUTPUTS];   //Brightness in percent of each output
+}tsScene;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    Scene_Init(void);
+bool    Scene_Store(u8 ucSceneIdx, const tsScene* psScene);
+bool    Scene_Get(u8 ucSceneIdx, tsScene* psScene);
+bool    Scene_Recall(u8 ucSceneIdx);
+
+bool    Scene_StartPendingWrite(void);
+void    Scene_WriteDone(bool bSuccess);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_SCENE_H_
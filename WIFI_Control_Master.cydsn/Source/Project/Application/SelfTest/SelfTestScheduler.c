@@ -0,0 +1,176 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       SelfTestScheduler.c
+\brief      The cyclic self-tests are run step by step. Each call of the OS
+            cyclic self-test is one step and its execution time is measured.
+            A step is started early when the duty cycle budget covers its worst
+            case and no event is pending. Otherwise it is forced at its
+            deadline, so a complete cycle is always done within
+            SELFTEST_C_COVERAGE_PERIOD_MS.
+
+***********************************************************************************/
+#include "OS_SelfTest.h"
+#include "SelfTestScheduler.h"
+#include "DR_System.h"
+
+/****************************************** Defines ******************************************************/
+
+/****************************************** Variables ****************************************************/
+static tsSelfTestStatistic sStatistic;
+
+static u32 ulStepMaxCycles[SELFTEST_C_STEPS];
+static u32 ulCreditCycles = 0;          //Budget which was earned with the duty cycle
+static u32 ulLastCreditCycles = 0;      //Cycle count of the last budget update
+static u32 ulCycleStartMs = 0;
+static u8  ucStepIdx = 0;
+
+/****************************************** Function prototypes ******************************************/
+static void UpdateCredit(void);
+static void FinishStep(u32 ulStepCycles);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Adds the duty cycle share of the elapsed time to the budget. The
+            budget is limited to the worst case of the next step, so steps
+            don't run back to back after a long pause.
+\return     none
+\param      none
+***********************************************************************************/
+static void UpdateCredit(void)
+{
+    const u32 ulNow = DR_System_GetCycleCount();
+    const u32 ulElapsed = ulNow - ulLastCreditCycles;
+    ulLastCreditCycles = ulNow;
+
+    /* Divide first to avoid an overflow after a long sleep */
+    ulCreditCycles += (ulElapsed / 100) * SELFTEST_C_DUTY_PERCENT;
+
+    if(ulCreditCycles > ulStepMaxCycles[ucStepIdx])
+    {
+        ulCreditCycles = ulStepMaxCycles[ucStepIdx];
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Updates the worst case of the step and the coverage period when the
+            cycle is complete.
+\return     none
+\param      ulStepCycles - Execution time of the step in cycles
+***********************************************************************************/
+static void FinishStep(u32 ulStepCycles)
+{
+    if(ulStepCycles > ulStepMaxCycles[ucStepIdx])
+    {
+        ulStepMaxCycles[ucStepIdx] = ulStepCycles;
+
+        const u32 ulStepUs = DR_System_CyclesToUs(ulStepCycles);
+        sStatistic.auiStepMaxUs[ucStepIdx] = (ulStepUs > 0xFFFF) ? 0xFFFF : (u16)ulStepUs;
+    }
+
+    /* The step is paid from the budget. A forced step can't take more than there is */
+    ulCreditCycles = (ulCreditCycles > ulStepCycles) ? (ulCreditCycles - ulStepCycles) : 0;
+
+    if(++ucStepIdx >= SELFTEST_C_STEPS)
+    {
+        const u32 ulTickMs = DR_System_GetTickMs();
+        const u32 ulPeriodMs = ulTickMs - ulCycleStartMs;
+
+        sStatistic.uiCoveragePeriodMs = (ulPeriodMs > 0xFFFF) ? 0xFFFF : (u16)ulPeriodMs;
+
+        if(sStatistic.uiCoveragePeriodMs > sStatistic.uiCoveragePeriodMaxMs)
+        {
+            sStatistic.uiCoveragePeriodMaxMs = sStatistic.uiCoveragePeriodMs;
+        }
+
+        if(ulPeriodMs > SELFTEST_C_COVERAGE_PERIOD_MS && sStatistic.uiMissedPeriods < 0xFFFF)
+        {
+            sStatistic.uiMissedPeriods++;
+        }
+
+        ucStepIdx = 0;
+        ulCycleStartMs = ulTickMs;
+    }
+}
+
+/****************************************** External visible functiones **********************************/
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Starts the first coverage cycle. Has to be called after the time
+            base was started.
+\return     none
+\param      none
+***********************************************************************************/
+void SelfTestScheduler_Init(void)
+{
+    memset(&sStatistic, 0, sizeof(sStatistic));
+    memset(ulStepMaxCycles, 0, sizeof(ulStepMaxCycles));
+
+    ulCreditCycles = 0;
+    ulLastCreditCycles = DR_System_GetCycleCount();
+    ulCycleStartMs = DR_System_GetTickMs();
+    ucStepIdx = 0;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Runs the next self-test step when the budget allows it and no event
+            is pending, or when the deadline of the step is reached. The
+            deadlines are spread equally over the coverage period.
+\return     bool - True when a step was run
+\param      bEventsPending - True when the main task has pending events
+***********************************************************************************/
+bool SelfTestScheduler_Run(bool bEventsPending)
+{
+    UpdateCredit();
+
+    const u32 ulDeadlineMs = ((u32)(ucStepIdx + 1) * SELFTEST_C_COVERAGE_PERIOD_MS) / SELFTEST_C_STEPS;
+    const bool bDeadline = (DR_System_GetTickMs() - ulCycleStartMs) >= ulDeadlineMs;
+    const bool bBudget = (bEventsPending == false) && (ulCreditCycles >= ulStepMaxCycles[ucStepIdx]);
+
+    if(bDeadline == false && bBudget == false)
+    {
+        return false;
+    }
+
+    if(bBudget == false && sStatistic.uiForcedSteps < 0xFFFF)
+    {
+        sStatistic.uiForcedSteps++;
+    }
+
+    const u32 ulStepStart = DR_System_GetCycleCount();
+    OS_SelfTest_Cyclic_Run();
+    FinishStep(DR_System_GetCycleCount() - ulStepStart);
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the measured step costs and coverage periods.
+\return     tsSelfTestStatistic - Pointer to the statistic
+\param      none
+***********************************************************************************/
+const tsSelfTestStatistic* SelfTestScheduler_GetStatistic(void)
+{
+    return &sStatistic;
+}
@@ -0,0 +1,46 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       SelfTestScheduler.h
+\brief      Time sliced scheduling of the cyclic self-tests
+
+***********************************************************************************/
+#ifndef _SELFTESTSCHEDULER_H_
+#define _SELFTESTSCHEDULER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "SelfTest_Config.h"
+
+/***************************** defines / macros ******************************/
+
+/****************************** type definitions *****************************/
+typedef struct
+{
+    u16 auiStepMaxUs[SELFTEST_C_STEPS];     //Measured worst case of each step
+    u16 uiCoveragePeriodMs;                 //Duration of the last complete cycle
+    u16 uiCoveragePeriodMaxMs;              //Longest complete cycle since the start
+    u16 uiForcedSteps;                      //Steps which were run at their deadline without budget
+    u16 uiMissedPeriods;                    //Cycles which took longer than SELFTEST_C_COVERAGE_PERIOD_MS
+}tsSelfTestStatistic;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    SelfTestScheduler_Init(void);
+bool    SelfTestScheduler_Run(bool bEventsPending);
+const tsSelfTestStatistic* SelfTestScheduler_GetStatistic(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_SELFTESTSCHEDULER_H_
@@ -0,0 +1,318 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       SunTime.c
+\brief      Calculates sunrise and sunset of the configured location for the
+            local day. The declination and the equation of time use the Fourier
+            series of the NOAA solar calculation at noon of the day. The hour
+            angle of the sun at -0.833 degree (refraction and radius of the sun)
+            gives the time between noon and sunrise or sunset.
+            All angles are binary angles (65536 = 360 degree). Sine and cosine
+            use a quarter wave table with linear interpolation in Q15. The arc
+            cosine is a binary search on the cosine. No floating point is used.
+            The result is calculated once per day or when the location or the
+            UTC offset changes.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "Aom.h"
+#include "Aom_Time.h"
+#include "SunTime.h"
+
+/****************************************** Defines ******************************************************/
+#define SECONDS_PER_DAY         86400
+#define SECONDS_AT_NOON         43200
+#define DAYS_PER_4_YEARS        1461    //Leap year cycle from 1970 until 2099
+
+#define ANGLE_QUARTER           0x4000  //90 degree as binary angle
+#define ANGLE_HALF              0x8000  //180 degree as binary angle
+#define SINE_TABLE_STEPS        64      //Steps of the quarter wave
+#define SINE_TABLE_SHIFT        8       //Binary angle bits between two table steps
+
+#define SUN_ALTITUDE_SINE       (-476)  //Sine of -0.833 degree in Q15
+
+/****************************************** Variables ****************************************************/
+/* Sine of the quarter wave in Q15 */
+static const s16 siSineTable[SINE_TABLE_STEPS + 1] =
+{
+    0, 804, 1608, 2411, 3212, 4011, 4808, 5602, 6393, 7180, 7962, 8740, 9512, 10279, 11039, 11793,
+    12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531, 18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+    23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791, 27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+    30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972, 32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+    32767
+};
+
+static bool bCalculated = false;
+static u32  ulCalculatedDay = 0;
+static s16  siCalculatedOffset = 0;
+static s16  siCalculatedLatitude = 0;
+static s16  siCalculatedLongitude = 0;
+
+static u16  uiSunrise = SUN_TIME_INVALID;       //Local minute of the day
+static u16  uiSunset = SUN_TIME_INVALID;
+
+/****************************************** Function prototypes ******************************************/
+static s16  Sine(u16 uiAngle);
+static s16  Cosine(u16 uiAngle);
+static u16  ArcCosine(s16 siValue);
+static u16  GetDayOfYear(u32 ulDay);
+static bool CalculateSunTimes(u16 uiDayOfYear, s16 siLatitude, s16 siLongitude, s32* pslSunrise, s32* pslSunset);
+static u16  ToLocalMinute(s32 slUtcSeconds, s16 siOffsetMin);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Sine of a binary angle with the interpolated quarter wave table.
+\return     s16 - The sine in Q15
+\param      uiAngle - The binary angle
+***********************************************************************************/
+static s16 Sine(u16 uiAngle)
+{
+    const u8 ucQuadrant = uiAngle / ANGLE_QUARTER;
+    u16 uiIdx = uiAngle % ANGLE_QUARTER;
+
+    /* The second and fourth quadrant run backwards */
+    if(ucQuadrant & 0x01)
+    {
+        uiIdx = ANGLE_QUARTER - uiIdx;
+    }
+
+    const u8 ucTableIdx = uiIdx >> SINE_TABLE_SHIFT;
+    s32 slValue = siSineTable[ucTableIdx];
+
+    if(ucTableIdx < SINE_TABLE_STEPS)
+    {
+        const s32 slFraction = uiIdx & ((0x01 << SINE_TABLE_SHIFT) - 1);
+        slValue += ((siSineTable[ucTableIdx + 1] - slValue) * slFraction) >> SINE_TABLE_SHIFT;
+    }
+
+    /* The third and fourth quadrant are negative */
+    return (s16)((ucQuadrant & 0x02) ? -slValue : slValue);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Cosine of a binary angle.
+\return     s16 - The cosine in Q15
+\param      uiAngle - The binary angle
+***********************************************************************************/
+static s16 Cosine(u16 uiAngle)
+{
+    return Sine(uiAngle + ANGLE_QUARTER);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Arc cosine with a binary search. The cosine falls monotonously from
+            0 to 180 degree.
+\return     u16 - The binary angle between 0 and 180 degree
+\param      siValue - The cosine in Q15
+***********************************************************************************/
+static u16 ArcCosine(s16 siValue)
+{
+    u16 uiLow = 0;
+    u16 uiHigh = ANGLE_HALF;
+
+    while(uiHigh - uiLow > 1)
+    {
+        const u16 uiMid = (uiLow + uiHigh) / 2;
+
+        if(Cosine(uiMid) > siValue)
+        {
+            uiLow = uiMid;
+        }
+        else
+        {
+            uiHigh = uiMid;
+        }
+    }
+
+    return uiLow;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the day of the year. Every fourth year is a leap year
+            which is valid until 2099.
+\return     u16 - Day of the year. 1 = 1st of January
+\param      ulDay - The day since 01.01.1970
+***********************************************************************************/
+static u16 GetDayOfYear(u32 ulDay)
+{
+    /* Cycle starts with 1970 */
+    static const u16 uiYearDays[4] = {365, 365, 366, 365};
+
+    u16 uiDay = ulDay % DAYS_PER_4_YEARS;
+    u8 ucYear = 0;
+
+    while(uiDay >= uiYearDays[ucYear])
+    {
+        uiDay -= uiYearDays[ucYear];
+        ucYear++;
+    }
+
+    return uiDay + 1;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the UTC time of the sunrise and the sunset.
+\return     bool - False when the sun doesn't rise or doesn't set on this day
+\param      uiDayOfYear - Day of the year. 1 = 1st of January
+\param      siLatitude - Latitude in 1/100 degree
+\param      siLongitude - Longitude in 1/100 degree
+\param      pslSunrise - Sunrise in seconds since midnight UTC. Can be negative
+                         or behind the day for far away time zones
+\param      pslSunset - Sunset in seconds since midnight UTC
+***********************************************************************************/
+static bool CalculateSunTimes(u16 uiDayOfYear, s16 siLatitude, s16 siLongitude, s32* pslSunrise, s32* pslSunset)
+{
+    /* Fractional year at noon of the day */
+    const u16 uiYear = (u16)((((u32)(uiDayOfYear - 1) * 2 + 1) * ANGLE_HALF) / 365);
+
+    const s32 slCos1 = Cosine(uiYear);
+    const s32 slSin1 = Sine(uiYear);
+    const s32 slCos2 = Cosine(uiYear * 2);
+    const s32 slSin2 = Sine(uiYear * 2);
+    const s32 slCos3 = Cosine(uiYear * 3);
+    const s32 slSin3 = Sine(uiYear * 3);
+
+    /* Declination. The coefficients are in 1/8 binary angle units */
+    const s32 slDeclination = (577L * 32768) - (33370L * slCos1) + (5862L * slSin1) - (564L * slCos2)
+                              + (76L * slSin2) - (225L * slCos3) + (123L * slSin3);
+    const u16 uiDeclination = (u16)(s16)(slDeclination / (32768L * 8));
+
+    /* Equation of time. The coefficients are in 1/16 seconds */
+    const s32 slEquation = (17L * 32768) + (411L * slCos1) - (7057L * slSin1) - (3216L * slCos2) - (8987L * slSin2);
+    const s32 slEquationSec = slEquation / (32768L * 16);
+
+    /* Hour angle of the sun at the horizon */
+    const u16 uiLatitude = (u16)(s16)(((s32)siLatitude * 65536) / 36000);
+
+    const s32 slSinProduct = ((s32)Sine(uiLatitude) * Sine(uiDeclination)) >> 15;
+    const s32 slCosProduct = ((s32)Cosine(uiLatitude) * Cosine(uiDeclination)) >> 15;
+    const s32 slNumerator = SUN_ALTITUDE_SINE - slSinProduct;
+
+    /* Polar night or midnight sun */
+    if(slCosProduct <= 0 || slNumerator >= slCosProduct || slNumerator <= -slCosProduct)
+    {
+        return false;
+    }
+
+    const u16 uiHourAngle = ArcCosine((s16)((slNumerator * 32768) / slCosProduct));
+
+    /* 360 degree are one day. 1/100 degree longitude are 2.4 seconds */
+    const s32 slHourAngleSec = ((s32)uiHourAngle * 675) / 512;
+    const s32 slNoonSec = SECONDS_AT_NOON - (((s32)siLongitude * 12) / 5) - slEquationSec;
+
+    *pslSunrise = slNoonSec - slHourAngleSec;
+    *pslSunset = slNoonSec + slHourAngleSec;
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Converts a UTC time into the rounded local minute of the day.
+\return     u16 - The local minute of the day
+\param      slUtcSeconds - Seconds since midnight UTC. Within +-2 days
+\param      siOffsetMin - Offset of the local time to UTC
+***********************************************************************************/
+static u16 ToLocalMinute(s32 slUtcSeconds, s16 siOffsetMin)
+{
+    /* Shift into the positive range before the division */
+    const s32 slMinutes = ((slUtcSeconds + 30 + (2 * SECONDS_PER_DAY)) / 60) + siOffsetMin + MINUTES_PER_DAY;
+
+    return (u16)(slMinutes % MINUTES_PER_DAY);
+}
+
+/****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates sunrise and sunset when the local day, the UTC offset or
+            the location has changed since the last calculation.
+\return     bool - True when the times were calculated again
+\param      none
+***********************************************************************************/
+bool SunTime_Update(void)
+{
+    const tsSunTimerSettings* psSettings = &Aom_GetRegulationSettings()->sSunTimer;
+
+    /* No time received yet */
+    if(Aom_Time_GetCurrentTime()->ulTicks == 0)
+    {
+        return false;
+    }
+
+    const u32 ulDay = Aom_Time_GetLocalDay();
+    const s16 siOffsetMin = Aom_Time_GetUtcOffsetMin();
+
+    if(bCalculated && ulDay == ulCalculatedDay && siOffsetMin == siCalculatedOffset
+        && psSettings->siLatitude == siCalculatedLatitude && psSettings->siLongitude == siCalculatedLongitude)
+    {
+        return false;
+    }
+
+    bCalculated = true;
+    ulCalculatedDay = ulDay;
+    siCalculatedOffset = siOffsetMin;
+    siCalculatedLatitude = psSettings->siLatitude;
+    siCalculatedLongitude = psSettings->siLongitude;
+
+    s32 slSunrise;
+    s32 slSunset;
+
+    if(CalculateSunTimes(GetDayOfYear(ulDay), psSettings->siLatitude, psSettings->siLongitude, &slSunrise, &slSunset))
+    {
+        uiSunrise = ToLocalMinute(slSunrise, siOffsetMin);
+        uiSunset = ToLocalMinute(slSunset, siOffsetMin);
+    }
+    else
+    {
+        uiSunrise = SUN_TIME_INVALID;
+        uiSunset = SUN_TIME_INVALID;
+    }
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns sunrise and sunset of the local day.
+\return     bool - False when there is no sunrise and sunset
+\param      puiSunrise - Local minute of the day of the sunrise
+\param      puiSunset - Local minute of the day of the sunset
+***********************************************************************************/
+bool SunTime_GetTimes(u16* puiSunrise, u16* puiSunset)
+{
+    *puiSunrise = uiSunrise;
+    *puiSunset = uiSunset;
+
+    return (uiSunrise != SUN_TIME_INVALID);
+}
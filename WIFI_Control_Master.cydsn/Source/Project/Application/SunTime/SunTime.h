@@ -0,0 +1,38 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       SunTime.h
+\brief      Sunrise and sunset of the configured location. Calculated once per
+            day in fixed-point arithmetic.
+
+***********************************************************************************/
+#ifndef _SUNTIME_H_
+#define _SUNTIME_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+
+/***************************** defines / macros ******************************/
+#define SUN_TIME_INVALID        0xFFFF  //No sunrise or sunset on this day or no time received yet
+
+/****************************** type definitions *****************************/
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+bool    SunTime_Update(void);
+bool    SunTime_GetTimes(u16* puiSunrise, u16* puiSunset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_SUNTIME_H_
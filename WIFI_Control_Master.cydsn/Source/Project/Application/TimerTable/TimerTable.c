@@ -0,0 +1,659 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       TimerTable.c
+\brief      Table of weekly timer entries in an own flash area. Each entry has
+            a weekday mask, the target outputs and a brightness. The table is
+            compiled into the segments of the week. A segment starts at each
+            start or stop of an entry and holds the outputs and brightness
+            until the next segment. The current segment is found with a binary
+            search. The segment of the last search is checked first, so the
+            periodic evaluation needs no search at all.
+            A new table is uploaded entry by entry into a second buffer and is
+            only taken over when the CRC and the compilation succeed.
+            The table is stored alternately in two flash slots. A write goes
+            always into the slot which isn't used, so a torn write leaves the
+            last table untouched. The valid slot with the newest sequence is
+            used at the start.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "OS_Config.h"
+#include "DR_Flash.h"
+#include "Aom_Flash.h"
+#include "Aom_Time.h"
+#include "TimerTable.h"
+
+/****************************************** Defines ******************************************************/
+#define TIMER_TABLE_MAGIC       0x5A
+#define TIMER_TABLE_VERSION     1
+#define DAYS_PER_WEEK           7
+#define MINUTES_PER_WEEK        (DAYS_PER_WEEK * MINUTES_PER_DAY)
+#define TIMER_TABLE_SLOTS       2
+#define TIMER_TABLE_SLOT_ROWS   ((sizeof(tsTimerTableImage) + CY_FLASH_SIZEOF_ROW - 1) / CY_FLASH_SIZEOF_ROW)
+#define TIMER_TABLE_SLOT_SIZE   (TIMER_TABLE_SLOT_ROWS * CY_FLASH_SIZEOF_ROW)
+#define TIMER_TABLE_OUTPUT_MASK ((0x01 << DRIVE_OUTPUTS) - 1)
+
+typedef struct
+{
+    u8  ucMagic;
+    u8  ucVersion;
+    u8  ucEntryCount;
+    u8  ucSequence;                             //Incremented with each new table. The newer slot wins
+    u32 ulCrc;                                  //CRC over the used entries
+    tsTimerEntry asEntries[TIMER_TABLE_ENTRIES];
+}tsTimerTableImage;
+
+typedef struct
+{
+    u16 uiWeekMin;                              //Minute of the week when the segment starts. Monday 0:00 is zero
+    u8  ucOutputs;                              //Outputs which are switched on in this segment
+    u8  aucBrightness[DRIVE_OUTPUTS];
+}tsTimerSegment;
+
+/****************************************** Variables ****************************************************/
+/* Row aligned flash area of the timer table slots. Is read volatile because the content is changed by the flash writes */
+static const volatile u8 ucTimerTableFlash[TIMER_TABLE_SLOTS * TIMER_TABLE_SLOT_SIZE] CY_ALIGN(CY_FLASH_SIZEOF_ROW) = {0};
+
+static tsTimerTableImage sTable;                //Used table. Is also the source of the flash write
+static u8   ucTableSlot = TIMER_TABLE_SLOTS - 1;    //Slot with the newest valid table
+static u8   ucWriteSlot = 0;                    //Slot of the running write
+
+static tsTimerEntry asUploadEntries[TIMER_TABLE_ENTRIES];
+static u8   ucUploadCount = 0;
+static u8   ucUploadNext = 0;
+static bool bUploadRunning = false;
+
+static tsTimerSegment asSegments[TIMER_TABLE_SEGMENTS];
+static u16  uiSegmentCount = 0;
+static u16  uiLastSegment = 0;                  //Segment of the last search
+
+static bool bWritePending = false;
+static bool bWriteRunning = false;
+static u8   ucRetries = 0;
+
+/****************************************** Function prototypes ******************************************/
+static bool IsEntryValid(const tsTimerEntry* psEntry);
+static bool ReadSlot(u8 ucSlot, tsTimerTableImage* psImage);
+static bool IsEntryActive(const tsTimerEntry* psEntry, u16 uiWeekMin);
+static bool AddEdge(u16 uiWeekMin);
+static bool CompileIndex(const tsTimerEntry* psEntries, u8 ucEntryCount);
+static u16  FindSegment(u16 uiWeekMin);
+static bool IsSameState(const tsTimerSegment* psSegment, const tsTimerSegment* psOther);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Checks the ranges of an entry.
+\return     bool - True when the entry can be used
+\param      psEntry - The entry
+***********************************************************************************/
+static bool IsEntryValid(const tsTimerEntry* psEntry)
+{
+    return (psEntry->uiStartMin < MINUTES_PER_DAY
+            && psEntry->uiStopMin < MINUTES_PER_DAY
+            && (psEntry->ucWeekdays & ~TIMER_TABLE_ALL_WEEKDAYS) == 0
+            && (psEntry->ucOutputs & ~TIMER_TABLE_OUTPUT_MASK) == 0
+            && psEntry->ucBrightness >= PERCENT_LOW
+            && psEntry->ucBrightness <= PERCENT_HIGH);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads a slot of the table from the flash and checks it.
+\return     bool - True when the header, the CRC and all entries are valid
+\param      ucSlot - Index of the slot
+\param      psImage - Pointer to the table which shall be filled
+***********************************************************************************/
+static bool ReadSlot(u8 ucSlot, tsTimerTableImage* psImage)
+{
+    const volatile u8* pucFlash = &ucTimerTableFlash[ucSlot * TIMER_TABLE_SLOT_SIZE];
+    u8* pucImage = (u8*)psImage;
+
+    u16 uiByteIdx;
+    for(uiByteIdx = 0; uiByteIdx < sizeof(tsTimerTableImage); uiByteIdx++)
+    {
+        pucImage[uiByteIdx] = pucFlash[uiByteIdx];
+    }
+
+    bool bValid = (psImage->ucMagic == TIMER_TABLE_MAGIC
+                   && psImage->ucVersion == TIMER_TABLE_VERSION
+                   && psImage->ucEntryCount <= TIMER_TABLE_ENTRIES
+                   && psImage->ulCrc == Aom_Flash_CalculateCrc(psImage->asEntries, psImage->ucEntryCount * sizeof(tsTimerEntry)));
+
+    u8 ucEntryIdx;
+    for(ucEntryIdx = 0; bValid && ucEntryIdx < psImage->ucEntryCount; ucEntryIdx++)
+    {
+        bValid = IsEntryValid(&psImage->asEntries[ucEntryIdx]);
+    }
+
+    return bValid;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Checks if an entry is active in the minute of the week. An entry
+            which continues over midnight belongs to the day of its start.
+\return     bool - True when active
+\param      psEntry - The entry
+\param      uiWeekMin - The minute of the week
+***********************************************************************************/
+static bool IsEntryActive(const tsTimerEntry* psEntry, u16 uiWeekMin)
+{
+    const u8 ucDay = uiWeekMin / MINUTES_PER_DAY;
+    const u8 ucPrevDay = (ucDay + DAYS_PER_WEEK - 1) % DAYS_PER_WEEK;
+    const u16 uiMin = uiWeekMin % MINUTES_PER_DAY;
+    const bool bStartDay = (psEntry->ucWeekdays & (0x01 << ucDay)) != 0;
+
+    if(psEntry->uiStartMin < psEntry->uiStopMin)
+    {
+        return (bStartDay && uiMin >= psEntry->uiStartMin && uiMin < psEntry->uiStopMin);
+    }
+    else if(psEntry->uiStartMin > psEntry->uiStopMin)
+    {
+        return ((bStartDay && uiMin >= psEntry->uiStartMin)
+                || ((psEntry->ucWeekdays & (0x01 << ucPrevDay)) && uiMin < psEntry->uiStopMin));
+    }
+
+    return false;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Inserts a segment start into the sorted segment list. An existing
+            start isn't added twice.
+\return     bool - False when the segment list is full
+\param      uiWeekMin - The minute of the week
+***********************************************************************************/
+static bool AddEdge(u16 uiWeekMin)
+{
+    u16 uiIdx = uiSegmentCount;
+
+    /* Search the position from the end */
+    while(uiIdx > 0 && asSegments[uiIdx - 1].uiWeekMin > uiWeekMin)
+    {
+        uiIdx--;
+    }
+
+    if(uiIdx > 0 && asSegments[uiIdx - 1].uiWeekMin == uiWeekMin)
+    {
+        return true;
+    }
+
+    if(uiSegmentCount >= TIMER_TABLE_SEGMENTS)
+    {
+        return false;
+    }
+
+    memmove(&asSegments[uiIdx + 1], &asSegments[uiIdx], (uiSegmentCount - uiIdx) * sizeof(tsTimerSegment));
+    asSegments[uiIdx].uiWeekMin = uiWeekMin;
+    uiSegmentCount++;
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Compiles the entries into the segments of the week. Neighbouring
+            segments with the same state are merged afterwards.
+\return     bool - False when the entries need more than TIMER_TABLE_SEGMENTS
+\param      psEntries - The entries
+\param      ucEntryCount - Amount of entries
+***********************************************************************************/
+static bool CompileIndex(const tsTimerEntry* psEntries, u8 ucEntryCount)
+{
+    memset(asSegments, 0, sizeof(asSegments));
+    uiSegmentCount = 0;
+    uiLastSegment = 0;
+
+    /* The first segment starts always on Monday 0:00 */
+    AddEdge(0);
+
+    u8 ucEntryIdx;
+    for(ucEntryIdx = 0; ucEntryIdx < ucEntryCount; ucEntryIdx++)
+    {
+        const tsTimerEntry* psEntry = &psEntries[ucEntryIdx];
+
+        if(psEntry->uiStartMin == psEntry->uiStopMin)
+        {
+            continue;
+        }
+
+        u8 ucDay;
+        for(ucDay = 0; ucDay < DAYS_PER_WEEK; ucDay++)
+        {
+            if(psEntry->ucWeekdays & (0x01 << ucDay))
+            {
+                const u16 uiDayStart = ucDay * MINUTES_PER_DAY;
+                const u16 uiStop = uiDayStart + psEntry->uiStopMin + ((psEntry->uiStopMin < psEntry->uiStartMin) ? MINUTES_PER_DAY : 0);
+
+                if(AddEdge(uiDayStart + psEntry->uiStartMin) == false
+                    || AddEdge(uiStop % MINUTES_PER_WEEK) == false)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    /* State of each segment. Overlapping entries use the highest brightness */
+    u16 uiSegmentIdx;
+    for(uiSegmentIdx = 0; uiSegmentIdx < uiSegmentCount; uiSegmentIdx++)
+    {
+        tsTimerSegment* psSegment = &asSegments[uiSegmentIdx];
+
+        for(ucEntryIdx = 0; ucEntryIdx < ucEntryCount; ucEntryIdx++)
+        {
+            const tsTimerEntry* psEntry = &psEntries[ucEntryIdx];
+
+            if(IsEntryActive(psEntry, psSegment->uiWeekMin))
+            {
+                psSegment->ucOutputs |= psEntry->ucOutputs;
+
+                u8 ucOutputIdx;
+                for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
+                {
+                    if((psEntry->ucOutputs & (0x01 << ucOutputIdx)) && psEntry->ucBrightness > psSegment->aucBrightness[ucOutputIdx])
+                    {
+                        psSegment->aucBrightness[ucOutputIdx] = psEntry->ucBrightness;
+                    }
+                }
+            }
+        }
+    }
+
+    /* Merge the segments which don't change anything */
+    u16 uiUsedCount = 1;
+    for(uiSegmentIdx = 1; uiSegmentIdx < uiSegmentCount; uiSegmentIdx++)
+    {
+        if(IsSameState(&asSegments[uiSegmentIdx], &asSegments[uiUsedCount - 1]) == false)
+        {
+            asSegments[uiUsedCount++] = asSegments[uiSegmentIdx];
+        }
+    }
+    uiSegmentCount = uiUsedCount;
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Searches the segment of the minute. The last found segment and its
+            successor are checked first, otherwise a binary search is used.
+\return     u16 - Index of the segment
+\param      uiWeekMin - The minute of the week
+***********************************************************************************/
+static u16 FindSegment(u16 uiWeekMin)
+{
+    u16 uiCheckIdx;
+    for(uiCheckIdx = uiLastSegment; uiCheckIdx < uiSegmentCount && uiCheckIdx <= uiLastSegment + 1; uiCheckIdx++)
+    {
+        if(asSegments[uiCheckIdx].uiWeekMin <= uiWeekMin
+            && (uiCheckIdx + 1 == uiSegmentCount || asSegments[uiCheckIdx + 1].uiWeekMin > uiWeekMin))
+        {
+            uiLastSegment = uiCheckIdx;
+            return uiCheckIdx;
+        }
+    }
+
+    /* Last segment which starts before or in the minute */
+    u16 uiLow = 0;
+    u16 uiHigh = uiSegmentCount - 1;
+
+    while(uiLow < uiHigh)
+    {
+        const u16 uiMid = (uiLow + uiHigh + 1) / 2;
+
+        if(asSegments[uiMid].uiWeekMin <= uiWeekMin)
+        {
+            uiLow = uiMid;
+        }
+        else
+        {
+            uiHigh = uiMid - 1;
+        }
+    }
+
+    uiLastSegment = uiLow;
+    return uiLow;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Compares the outputs and the brightness of two segments.
+\return     bool - True when both switch the same
+\param      psSegment - The first segment
+\param      psOther - The second segment
+***********************************************************************************/
+static bool IsSameState(const tsTimerSegment* psSegment, const tsTimerSegment* psOther)
+{
+    return (psSegment->ucOutputs == psOther->ucOutputs
+            && memcmp(psSegment->aucBrightness, psOther->aucBrightness, sizeof(psSegment->aucBrightness)) == 0);
+}
+
+/****************************************** External visible functiones **********************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Reads the newest valid table from the flash slots and compiles it.
+            When no slot is valid the table is empty.
+\return     none
+\param      none
+***********************************************************************************/
+void TimerTable_Init(void)
+{
+    tsTimerTableImage sImage;
+    bool bValid = false;
+
+    /* Search the newest valid slot. The sequence difference handles the overflow */
+    u8 ucSlot;
+    for(ucSlot = 0; ucSlot < TIMER_TABLE_SLOTS; ucSlot++)
+    {
+        if(ReadSlot(ucSlot, &sImage)
+            && (bValid == false || (s8)(sImage.ucSequence - sTable.ucSequence) > 0))
+        {
+            memcpy(&sTable, &sImage, sizeof(sImage));
+            ucTableSlot = ucSlot;
+            bValid = true;
+        }
+    }
+
+    if(bValid == false || CompileIndex(sTable.asEntries, sTable.ucEntryCount) == false)
+    {
+        memset(&sTable, 0, sizeof(sTable));
+        sTable.ucMagic = TIMER_TABLE_MAGIC;
+        sTable.ucVersion = TIMER_TABLE_VERSION;
+        sTable.ulCrc = Aom_Flash_CalculateCrc(sTable.asEntries, 0);
+
+        CompileIndex(sTable.asEntries, 0);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Starts the upload of a new table. A running upload is dropped.
+\return     bool - False when the table has too many entries
+\param      ucEntryCount - Amount of entries of the new table
+***********************************************************************************/
+bool TimerTable_BeginUpload(u8 ucEntryCount)
+{
+    bUploadRunning = false;
+
+    if(ucEntryCount > TIMER_TABLE_ENTRIES)
+    {
+        return false;
+    }
+
+    ucUploadCount = ucEntryCount;
+    ucUploadNext = 0;
+    bUploadRunning = true;
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Takes over the next entry of the upload. The entries have to be
+            sent in order. An invalid entry cancels the upload.
+\return     bool - True when the entry was taken over
+\param      ucEntryIdx - Index of the entry in the new table
+\param      psEntry - The entry
+***********************************************************************************/
+bool TimerTable_UploadEntry(u8 ucEntryIdx, const tsTimerEntry* psEntry)
+{
+    if(bUploadRunning == false || ucEntryIdx != ucUploadNext || ucEntryIdx >= ucUploadCount)
+    {
+        return false;
+    }
+
+    if(IsEntryValid(psEntry) == false)
+    {
+        bUploadRunning = false;
+        return false;
+    }
+
+    asUploadEntries[ucUploadNext++] = *psEntry;
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Finishes the upload. The new table is used and written into the
+            flash when all entries were received, the CRC matches and the
+            table fits into the segments. Otherwise the old table stays.
+\return     bool - True when the new table is used
+\param      ulTableCrc - CRC of the entries calculated by the sender
+***********************************************************************************/
+bool TimerTable_EndUpload(u32 ulTableCrc)
+{
+    if(bUploadRunning == false || ucUploadNext != ucUploadCount)
+    {
+        return false;
+    }
+
+    bUploadRunning = false;
+
+    if(ulTableCrc != Aom_Flash_CalculateCrc(asUploadEntries, ucUploadCount * sizeof(tsTimerEntry)))
+    {
+        return false;
+    }
+
+    if(CompileIndex(asUploadEntries, ucUploadCount) == false)
+    {
+        CompileIndex(sTable.asEntries, sTable.ucEntryCount);
+        return false;
+    }
+
+    memset(sTable.asEntries, 0, sizeof(sTable.asEntries));
+    memcpy(sTable.asEntries, asUploadEntries, ucUploadCount * sizeof(tsTimerEntry));
+    sTable.ucEntryCount = ucUploadCount;
+    sTable.ulCrc = ulTableCrc;
+    sTable.ucSequence++;
+
+    bWritePending = true;
+    ucRetries = 0;
+    TimerTable_StartPendingWrite();
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Copies an entry of the used table.
+\return     bool - False when the entry doesn't exist
+\param      ucEntryIdx - Index of the entry
+\param      psEntry - Pointer to the entry which shall be filled
+***********************************************************************************/
+bool TimerTable_GetEntry(u8 ucEntryIdx, tsTimerEntry* psEntry)
+{
+    if(ucEntryIdx >= sTable.ucEntryCount)
+    {
+        return false;
+    }
+
+    *psEntry = sTable.asEntries[ucEntryIdx];
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the amount of entries of the used table.
+\return     u8 - The entry count
+\param      none
+***********************************************************************************/
+u8 TimerTable_GetEntryCount(void)
+{
+    return sTable.ucEntryCount;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the CRC of the used table.
+\return     u32 - The CRC over the entries
+\param      none
+***********************************************************************************/
+u32 TimerTable_GetCrc(void)
+{
+    return sTable.ulCrc;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the outputs which are switched on by the table and their
+            brightness.
+\return     u8 - Bit per switched output
+\param      ucWeekday - Day of the week. 0 = Monday
+\param      uiMinOfDay - The minute of the day
+\param      pucBrightness - Array of DRIVE_OUTPUTS for the brightness. Zero when
+                            the output isn't switched by the table
+***********************************************************************************/
+u8 TimerTable_GetOutputs(u8 ucWeekday, u16 uiMinOfDay, u8* pucBrightness)
+{
+    if(ucWeekday >= DAYS_PER_WEEK || uiMinOfDay >= MINUTES_PER_DAY)
+    {
+        memset(pucBrightness, 0, DRIVE_OUTPUTS);
+        return 0;
+    }
+
+    const tsTimerSegment* psSegment = &asSegments[FindSegment((ucWeekday * MINUTES_PER_DAY) + uiMinOfDay)];
+
+    memcpy(pucBrightness, psSegment->aucBrightness, DRIVE_OUTPUTS);
+    return psSegment->ucOutputs;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Calculates the minutes until the table switches the next time.
+\return     u16 - Minutes until the next change. 0 when the table never changes
+\param      ucWeekday - Day of the week. 0 = Monday
+\param      uiMinOfDay - The minute of the day
+***********************************************************************************/
+u16 TimerTable_GetMinutesToNextEdge(u8 ucWeekday, u16 uiMinOfDay)
+{
+    if(ucWeekday >= DAYS_PER_WEEK || uiMinOfDay >= MINUTES_PER_DAY || uiSegmentCount < 2)
+    {
+        return 0;
+    }
+
+    const u16 uiWeekMin = (ucWeekday * MINUTES_PER_DAY) + uiMinOfDay;
+    const u16 uiSegmentIdx = FindSegment(uiWeekMin);
+
+    /* The segment on Monday 0:00 can have the same state as the last one */
+    u16 uiStep;
+    for(uiStep = 1; uiStep < uiSegmentCount; uiStep++)
+    {
+        const tsTimerSegment* psNext = &asSegments[(uiSegmentIdx + uiStep) % uiSegmentCount];
+
+        if(IsSameState(psNext, &asSegments[uiSegmentIdx]) == false)
+        {
+            return (psNext->uiWeekMin + MINUTES_PER_WEEK - uiWeekMin) % MINUTES_PER_WEEK;
+        }
+    }
+
+    return 0;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Starts a requested write of the table into the slot which isn't
+            used.
+\return     bool - True when the write was started
+\param      none
+***********************************************************************************/
+bool TimerTable_StartPendingWrite(void)
+{
+    if(bWritePending == false || bWriteRunning)
+    {
+        return false;
+    }
+
+    const u8 ucSlot = (ucTableSlot + 1) % TIMER_TABLE_SLOTS;
+    const u32 ulFlashRow = FLASH_ROW_OF(ucTimerTableFlash) + (ucSlot * TIMER_TABLE_SLOT_ROWS);
+
+    if(DR_Flash_StartWrite(eFlashJob_TimerTable, ulFlashRow, &sTable, sizeof(sTable)))
+    {
+        ucWriteSlot = ucSlot;
+        bWritePending = false;
+        bWriteRunning = true;
+    }
+
+    return bWriteRunning;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Takes over the written slot or repeats a failed write of the table.
+\return     none
+\param      bSuccess - True when the rows were programmed and verified
+***********************************************************************************/
+void TimerTable_WriteDone(bool bSuccess)
+{
+    bWriteRunning = false;
+
+    if(bSuccess)
+    {
+        ucTableSlot = ucWriteSlot;
+        ucRetries = 0;
+    }
+    else if(ucRetries < FLASH_WRITE_RETRIES)
+    {
+        ucRetries++;
+        bWritePending = true;
+    }
+}
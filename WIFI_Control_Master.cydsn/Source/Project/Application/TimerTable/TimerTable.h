@@ -0,0 +1,60 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       TimerTable.h
+\brief      Table of weekly timer entries with target outputs and brightness.
+            The table is compiled into a sorted list of the segments of the
+            week which is searched for the current state.
+
+***********************************************************************************/
+#ifndef _TIMERTABLE_H_
+#define _TIMERTABLE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "Project_Config.h"
+
+/***************************** defines / macros ******************************/
+#define TIMER_TABLE_ALL_WEEKDAYS    0x7F    //Bit 0 = Monday .. Bit 6 = Sunday
+
+/****************************** type definitions *****************************/
+typedef struct
+{
+    u16 uiStartMin;     //Minute of the day when the entry starts
+    u16 uiStopMin;      //Minute of the day when the entry ends. Before the start the entry continues over midnight
+    u8  ucWeekdays;     //Days on which the entry starts. Bit 0 = Monday .. Bit 6 = Sunday
+    u8  ucOutputs;      //Bit per output which is switched on
+    u8  ucBrightness;   //Brightness in percent of the switched outputs
+    u8  ucReserved;
+}tsTimerEntry;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    TimerTable_Init(void);
+bool    TimerTable_BeginUpload(u8 ucEntryCount);
+bool    TimerTable_UploadEntry(u8 ucEntryIdx, const tsTimerEntry* psEntry);
+bool    TimerTable_EndUpload(u32 ulTableCrc);
+bool    TimerTable_GetEntry(u8 ucEntryIdx, tsTimerEntry* psEntry);
+u8      TimerTable_GetEntryCount(void);
+u32     TimerTable_GetCrc(void);
+
+u8      TimerTable_GetOutputs(u8 ucWeekday, u16 uiMinOfDay, u8* pucBrightness);
+u16     TimerTable_GetMinutesToNextEdge(u8 ucWeekday, u16 uiMinOfDay);
+
+bool    TimerTable_StartPendingWrite(void);
+void    TimerTable_WriteDone(bool bSuccess);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_TIMERTABLE_H_
@@ -0,0 +1,178 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       DR_Flash.c
+\brief      Flash write engine for the main task. The data of a write job is
+            copied when the job is started and programmed one row per call of
+            DR_Flash_Process. The main task calls it only when no event is
+            pending, so a regulation tick waits at most for one row. Each row
+            is read back after programming. The end of the job is reported with
+            the event eEvtFlashWriteDone.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "OS_Config.h"
+#include "OS_EventManager.h"
+#include "DR_Flash.h"
+#include "EventQueue.h"
+
+/****************************************** Defines ******************************************************/
+typedef struct
+{
+    u32 ulFirstRow;
+    u16 uiSize;
+    u16 uiOffset;           //Bytes which are already programmed
+    teFlashJob eJob;
+    bool bBusy;
+}tsFlashJob;
+
+/****************************************** Variables ****************************************************/
+static u8 ucJobData[FLASH_JOB_MAX_ROWS * CY_FLASH_SIZEOF_ROW];
+static u8 ucRowData[CY_FLASH_SIZEOF_ROW];
+static tsFlashJob sJob = {0, 0, 0, eFlashJob_Max, false};
+static u32 ulProgrammedRows = 0;
+
+/****************************************** Function prototypes ******************************************/
+static void FinishJob(bool bSuccess);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Releases the job and posts the result.
+\return     none
+\param      bSuccess - True when all rows were programmed and verified
+***********************************************************************************/
+static void FinishJob(bool bSuccess)
+{
+    const teFlashJob eJob = sJob.eJob;
+
+    sJob.bBusy = false;
+
+    EventQueue_PostToOs(eEvtFlashWriteDone, bSuccess, eJob);
+}
+
+/****************************************** External visible functiones **********************************/
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Copies the data and starts a new write job. The rows are programmed
+            later with DR_Flash_Process. May be called from an interrupt.
+\return     bool - False when a job is running or the data doesn't fit
+\param      eJob - ID of the job which is reported with the done event
+\param      ulFirstRow - First flash row of the area. See FLASH_ROW_OF
+\param      pvData - Data which shall be written
+\param      uiSize - Size of the data. The last row is filled with zeros
+***********************************************************************************/
+bool DR_Flash_StartWrite(teFlashJob eJob, u32 ulFirstRow, const void* pvData, u16 uiSize)
+{
+    bool bStarted = false;
+
+    if(uiSize == 0 || uiSize > sizeof(ucJobData))
+    {
+        return false;
+    }
+
+    const u8 ucCriticalSection = EnterCritical();
+
+    if(sJob.bBusy == false)
+    {
+        memcpy(ucJobData, pvData, uiSize);
+
+        sJob.ulFirstRow = ulFirstRow;
+        sJob.uiSize = uiSize;
+        sJob.uiOffset = 0;
+        sJob.eJob = eJob;
+        sJob.bBusy = true;
+
+        bStarted = true;
+    }
+
+    LeaveCritical(ucCriticalSection);
+
+    return bStarted;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns true while a write job is running.
+\return     bool - True when busy
+\param      none
+***********************************************************************************/
+bool DR_Flash_IsBusy(void)
+{
+    return sJob.bBusy;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Programs and verifies the next row of the running job. The CPU is
+            stalled while the row is programmed.
+\return     bool - True when a row was programmed
+\param      none
+***********************************************************************************/
+bool DR_Flash_Process(void)
+{
+    if(sJob.bBusy == false)
+    {
+        return false;
+    }
+
+    const u32 ulRow = sJob.ulFirstRow + (sJob.uiOffset / CY_FLASH_SIZEOF_ROW);
+
+    u16 uiRowSize = sJob.uiSize - sJob.uiOffset;
+    if(uiRowSize > CY_FLASH_SIZEOF_ROW)
+    {
+        uiRowSize = CY_FLASH_SIZEOF_ROW;
+    }
+
+    memset(ucRowData, 0, sizeof(ucRowData));
+    memcpy(ucRowData, &ucJobData[sJob.uiOffset], uiRowSize);
+
+    bool bSuccess = (CySysFlashWriteRow(ulRow, ucRowData) == CY_SYS_FLASH_SUCCESS);
+    ulProgrammedRows++;
+
+    /* Read back the programmed row */
+    if(bSuccess)
+    {
+        const void* pvFlashRow = (const void*)(CY_FLASH_BASE + (ulRow * CY_FLASH_SIZEOF_ROW));
+        bSuccess = (memcmp(pvFlashRow, ucRowData, CY_FLASH_SIZEOF_ROW) == 0);
+    }
+
+    sJob.uiOffset += uiRowSize;
+
+    if(bSuccess == false || sJob.uiOffset >= sJob.uiSize)
+    {
+        FinishJob(bSuccess);
+    }
+
+    return true;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the programmed rows since the start. Each row is erased and
+            programmed completely.
+\return     ulProgrammedRows - The programmed rows
+\param      none
+***********************************************************************************/
+u32 DR_Flash_GetProgrammedRows(void)
+{
+    return ulProgrammedRows;
+}
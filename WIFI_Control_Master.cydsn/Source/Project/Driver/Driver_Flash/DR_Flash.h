@@ -0,0 +1,51 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       DR_Flash.h
+\brief      Non-blocking flash writes which are split into single rows
+
+***********************************************************************************/
+#ifndef _DR_FLASH_H_
+#define _DR_FLASH_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "Project_Config.h"
+
+/***************************** defines / macros ******************************/
+/* Address of a row aligned flash area in rows */
+#define FLASH_ROW_OF(pvFlash)   (((u32)(pvFlash) - CY_FLASH_BASE) / CY_FLASH_SIZEOF_ROW)
+
+/****************************** type definitions *****************************/
+typedef enum
+{
+    eFlashJob_UserSettings,
+    eFlashJob_SystemSettings,
+    eFlashJob_FaultLog,
+    eFlashJob_TimerTable,
+    eFlashJob_Scene,
+    eFlashJob_Occupancy,
+    eFlashJob_Max
+}teFlashJob;
+
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+bool    DR_Flash_StartWrite(teFlashJob eJob, u32 ulFirstRow, const void* pvData, u16 uiSize);
+bool    DR_Flash_IsBusy(void);
+bool    DR_Flash_Process(void);
+u32     DR_Flash_GetProgrammedRows(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_DR_FLASH_H_
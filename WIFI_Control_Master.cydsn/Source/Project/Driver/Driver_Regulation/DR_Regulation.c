@@ -24,6 +24,8 @@
 #include "Regulation_State_Init.h"
 #include "Regulation_State_Root.h"
 #include "DR_UserInterface.h"
+#include "DR_System.h"
+#include "EventQueue.h"
 
 #if (WITHOUT_REGULATION == false)
 /****************************************** Defines ******************************************************/
@@ -41,6 +43,13 @@ typedef struct
     s16  siAvg;
     u8   ucBufferIndex;
 }tsMovingAverageValues;
+
+typedef struct
+{
+    u16  uiStartValue;      //Is value of the output when the fade was started
+    u16  uiElapsedMs;
+    u16  uiFadeTimeMs;
+}tsFadeValues;
     
 /****************************************** Variables ****************************************************/
 static u16 uiLedCompareVal[DRIVE_OUTPUTS];
@@ -48,9 +57,23 @@ static u16 uiLedCompareVal[DRIVE_OUTPUTS];
 static tsMovingAverageValues uiAvgCompVal[DRIVE_OUTPUTS];
 static tsRegulationHandler sRegulationHandler[DRIVE_OUTPUTS];   
 static tCStateDefinition* psStateHandler[DRIVE_OUTPUTS] = {NULL, NULL, NULL};
+static tsFadeValues sFadeValues[DRIVE_OUTPUTS];
+
+/* Compare value of each output when the regulation has reached its requested value. Used to
+   calculate the compare value of the current requested value after a wake-up */
+static u16 uiReachedCompareVal[DRIVE_OUTPUTS];
+static u16 uiReachedReqValue[DRIVE_OUTPUTS];
+static volatile bool bFastWakeArmed = false;
+static volatile u8 ucFastWakeOutputs = 0;    //Set by the PIR interrupt. The outputs are restored in the main context
+
+static tsWakeLatency sWakeLatency;
+static u32 ulWakeStartCycles = 0;
+static u32 ulWakeStartTick = 0;
+static bool bWakeLatencyPending = false;
 
 /****************************************** Function prototypes ******************************************/
 static void RegulatePWM(u8 ucOutputIdx);
+static void FadeRequestedValue(u8 ucOutputIdx, u16 uiMilliSecElapsed);
 
 
 /****************************************** loacl functiones *********************************************/
@@ -93,6 +116,30 @@ static u16 PutInMovingAverage(u8 ucOutputIdx, u16 uiCompareValue)
     return uiAveragedCompareValue;
 }
 
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Fills the whole moving average filter with the given value. Thus the
+            first regulation cycle starts from this value.
+\return     none
+\param      ucOutputIdx - The output index which shall be filled
+\param      uiCompareValue - The value which is put into every buffer entry
+***********************************************************************************/
+static void FillMovingAverage(u8 ucOutputIdx, u16 uiCompareValue)
+{
+    tsMovingAverageValues* psAvgCompVal = &uiAvgCompVal[ucOutputIdx];
+    
+    u8 ucBufferIdx;
+    for(ucBufferIdx = 0; ucBufferIdx < _countof(psAvgCompVal->siBuffer); ucBufferIdx++)
+    {
+        psAvgCompVal->siBuffer[ucBufferIdx] = uiCompareValue;
+    }
+    
+    psAvgCompVal->siSum = uiCompareValue * AVG_BUFFER_SIZE;
+    psAvgCompVal->siAvg = uiCompareValue;
+}
+
 #if PWM_ISR_ENABLE
 //********************************************************************************
 /*!
@@ -340,6 +387,13 @@ static void RegulatePWM(u8 ucOutputIdx)
     {
         // Requested value reached
         psRegAdcVal->bReached = true;
+        
+        /* Remember the compare value of the requested value for the next wake-up */
+        if(sRegulationHandler[ucOutputIdx].sRegState.eRegulationState == eStateActiveR)
+        {
+            uiReachedCompareVal[ucOutputIdx] = uiLedCompareVal[ucOutputIdx];
+            uiReachedReqValue[ucOutputIdx] = psRegAdcVal->uiReqValue;
+        }
     }
     
     /* Average compare value */
@@ -354,6 +408,41 @@ static void RegulatePWM(u8 ucOutputIdx)
 }
 
 
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Replaces the requested value of the state by a linear ramp from the
+            start value to it while a fade is running.
+\return     none
+\param      ucOutputIdx - The output of the fade
+\param      uiMilliSecElapsed - The time since the last call
+***********************************************************************************/
+static void FadeRequestedValue(u8 ucOutputIdx, u16 uiMilliSecElapsed)
+{
+    tsFadeValues* psFade = &sFadeValues[ucOutputIdx];
+    tsRegAdcVal* psRegAdcVal = &sRegulationHandler[ucOutputIdx].sRegAdcVal;
+    
+    if(psFade->uiElapsedMs >= psFade->uiFadeTimeMs)
+    {
+        return;
+    }
+    
+    if(uiMilliSecElapsed < psFade->uiFadeTimeMs - psFade->uiElapsedMs)
+    {
+        psFade->uiElapsedMs += uiMilliSecElapsed;
+    }
+    else
+    {
+        psFade->uiElapsedMs = psFade->uiFadeTimeMs;
+    }
+    
+    const s32 slDifference = (s32)psRegAdcVal->uiReqValue - psFade->uiStartValue;
+    
+    psRegAdcVal->uiReqValue = psFade->uiStartValue + (s16)((slDifference * psFade->uiElapsedMs) / psFade->uiFadeTimeMs);
+}
+
+
 /****************************************** External visible functiones **********************************/
 
 //********************************************************************************
@@ -424,6 +513,14 @@ u8 DR_Regulation_Handler(u16 uiMilliSecElapsed)
     
     uiMilliSecCnt += uiMilliSecElapsed;
     
+    /* All outputs are regulated in the same cycle */
+    const bool bRegulationCycle = (uiMilliSecCnt >= REGULATION_CYCLES_MS);
+    
+    if(bRegulationCycle)
+    {
+        uiMilliSecCnt = 0;
+    }
+    
     u8 ucIsAnyOutputActive = 0;
     
     u8 ucOutputIdx;    
@@ -439,6 +536,9 @@ u8 DR_Regulation_Handler(u16 uiMilliSecElapsed)
             psRegState->pFctState(ucOutputIdx);
         }
         
+        /* A running fade approaches the requested value of the state */
+        FadeRequestedValue(ucOutputIdx, uiMilliSecElapsed);
+        
         /* Check if requested value has changed */
         if(psRegAdcVal->uiOldReqValue != psRegAdcVal->uiReqValue)
         {
@@ -453,10 +553,9 @@ u8 DR_Regulation_Handler(u16 uiMilliSecElapsed)
         
         
         /* Regulate PWM */
-        if(uiMilliSecCnt >= REGULATION_CYCLES_MS)
+        if(bRegulationCycle)
         {
             RegulatePWM(ucOutputIdx);
-            uiMilliSecCnt = 0;
         }
         
         if(psRegState->eRegulationState != eStateOff)
@@ -491,6 +590,27 @@ void DR_Regulation_ChangeState(teRegulationState eRequestedState, u8 ucOutputIdx
     }
 }
 
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Starts a fade of all outputs from their current value to the value
+         of their requested state. All outputs start in the same cycle of the
+         regulation handler.
+\param   uiFadeTimeMs - The time of the fade. Zero switches directly
+\return  none
+***********************************************************************************/
+void DR_Regulation_StartFade(u16 uiFadeTimeMs)
+{
+    u8 ucOutputIdx;
+    for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
+    {
+        sFadeValues[ucOutputIdx].uiStartValue = sRegulationHandler[ucOutputIdx].sRegAdcVal.uiIsValue;
+        sFadeValues[ucOutputIdx].uiElapsedMs = 0;
+        sFadeValues[ucOutputIdx].uiFadeTimeMs = uiFadeTimeMs;
+    }
+}
+
 //********************************************************************************
 /*!
 \author  KraemerE
@@ -654,6 +774,9 @@ void DR_Regulation_SetWakeupInterrupts(void)
     
     /* Set interrupt mode for PIR-pin to rising edge */
     Pin_PIR_SetInterruptMode(Pin_PIR_0_INTR, Pin_PIR_INTR_RISING);
+    
+    /* Allow the PIR interrupt to request the fast wake-up of the outputs */
+    bFastWakeArmed = true;
 }
 
 //********************************************************************************
@@ -672,6 +795,9 @@ void DR_Regulation_DeleteWakeupInterrupts(void)
                     
     /* Disable interrupts on PIR pin. Interrupt request is cleared in the GPIO Handler in Actors */
     Pin_PIR_SetInterruptMode(Pin_PIR_0_INTR, Pin_PIR_INTR_NONE);
+    
+    bFastWakeArmed = false;
+    ucFastWakeOutputs = 0;
 }
 
 //********************************************************************************
@@ -680,14 +806,24 @@ void DR_Regulation_DeleteWakeupInterrupts(void)
 \date    08.05.2021
 \brief   Enters the deep sleep mode of this controller.
          Sleep is leaved with the next interrupt from a 
-         wake up source (Watchdog-Timer or UART changes) 
+         wake up source (Watchdog-Timer or UART changes).
+         Has to be called with masked interrupts. The deep sleep is skipped
+         when a motion has requested the light since the wake-up sources
+         were enabled.
 \param   none
 \return  none
 ***********************************************************************************/
 void DR_Regulation_EnterDeepSleepMode(void)
 {
     //Enter deep sleep mode
-    CySysPmDeepSleep();
+    if(ucFastWakeOutputs == 0)
+    {
+        CySysPmDeepSleep();
+    }
+    
+    /* Woke up. Take the time stamp for the wake-up latency measurement */
+    ulWakeStartCycles = DR_System_GetCycleCount();
+    ulWakeStartTick = DR_System_GetTickMs();
 }
 
 
@@ -701,7 +837,7 @@ void DR_Regulation_EnterDeepSleepMode(void)
 ***********************************************************************************/
 void DR_Regulation_RxInterruptOnSleep(void)
 {
-    OS_EVT_PostEvent(eEvtStandby_RxToggled, 0, 0);
+    EventQueue_PostToOs(eEvtStandby_RxToggled, 0, 0);
 }
 
 
@@ -722,4 +858,148 @@ void DR_Regulation_GetPWMData(uint8_t ucOutputIdx, tsPwmData* psPwmData)
         psPwmData->bStatus = HAL_IO_GetPwmStatus(ucOutputIdx);
     }
 }
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Requests the fast wake-up of the outputs. Is called from the PIR
+         interrupt and only remembers the outputs. Does nothing when the
+         wake-up interrupts aren't armed (Not in standby).
+\param   ucOutputs - Bit per output which the automatic mode switches on
+\return  none
+***********************************************************************************/
+void DR_Regulation_RequestFastWake(u8 ucOutputs)
+{
+    if(bFastWakeArmed)
+    {
+        ucFastWakeOutputs |= ucOutputs;
+    }
+}
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Fast path from the PIR wake-up to the light. Enables the output
+         hardware of the outputs which the automatic mode switches on. Their
+         compare value is scaled from the compare value which has reached the
+         last requested value to the current requested value, so a changed
+         brightness or the night mode is taken into account. An output which
+         was never regulated is left to the entry state. The regulation state
+         machine continues from this compare value once the active state is
+         reached. Is called in the main context directly after the deep sleep
+         and does nothing without a request of the PIR interrupt.
+\param   none
+\return  bLightOn - True when at least one output was switched on
+***********************************************************************************/
+bool DR_Regulation_FastWakeOutputs(void)
+{
+    bool bLightOn = false;
+    
+    if(ucFastWakeOutputs && Aom_Measure_SystemVoltageCalculated())
+    {
+        /* Only once per wake-up */
+        const u8 ucOutputs = ucFastWakeOutputs;
+        bFastWakeArmed = false;
+        ucFastWakeOutputs = 0;
+        
+        u8 ucOutputIdx;
+        for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
+        {
+            const u16 uiReqValue = Aom_Measure_GetAdcRequestedValue(ucOutputIdx);
+            
+            if((ucOutputs & (0x01 << ucOutputIdx)) == 0 || uiReachedReqValue[ucOutputIdx] == 0 || uiReqValue == 0)
+            {
+                continue;
+            }
+            
+            /* The output voltage is nearly proportional to the duty cycle */
+            u16 uiPeriod = 0;
+            HAL_IO_PWM_ReadPeriod(ucOutputIdx, &uiPeriod);
+            
+            u32 ulCompareVal = ((u32)uiReachedCompareVal[ucOutputIdx] * uiReqValue) / uiReachedReqValue[ucOutputIdx];
+            ulCompareVal = (ulCompareVal > uiPeriod) ? uiPeriod : ulCompareVal;
+            const u16 uiCompareVal = (u16)ulCompareVal;
+            
+            if(uiCompareVal && HAL_IO_GetPwmStatus(ucOutputIdx) == false)
+            {
+                HAL_IO_PWM_Start(ucOutputIdx);
+                
+                if(DR_ErrorDetection_CheckPwmOutput(ucOutputIdx) == false)
+                {
+                    /* Same sequence as in the entry state but with the last compare value */
+                    HAL_IO_SetOutputStatus((ePin_PwmEn_0 + ucOutputIdx), ON);
+                    HAL_IO_SetOutputStatus((ePin_VoltEn_0 + ucOutputIdx), ON);
+                    HAL_IO_PWM_WriteCompare(ucOutputIdx, uiCompareVal);
+                    
+                    FillMovingAverage(ucOutputIdx, uiCompareVal);
+                    sRegulationHandler[ucOutputIdx].sRegState.eReqState = eStateActiveR;
+                    bLightOn = true;
+                }
+                else
+                {
+                    /* Leave the fault handling to the entry state */
+                    HAL_IO_PWM_Stop(ucOutputIdx);
+                }
+            }
+        }
+        
+        if(bLightOn)
+        {
+            const u32 ulLightOnUs = DR_System_CyclesToUs(DR_System_GetCycleCount() - ulWakeStartCycles);
+            
+            sWakeLatency.uiLightOnUs = (ulLightOnUs > 0xFFFF) ? 0xFFFF : (u16)ulLightOnUs;
+            if(sWakeLatency.uiLightOnUs > sWakeLatency.uiLightOnMaxUs)
+            {
+                sWakeLatency.uiLightOnMaxUs = sWakeLatency.uiLightOnUs;
+            }
+            
+            sWakeLatency.uiFastWakeCount++;
+            bWakeLatencyPending = true;
+        }
+    }
+    
+    return bLightOn;
+}
+
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Stops the wake-up latency measurement when the active state was entered
+         after a fast wake-up.
+\param   none
+\return  none
+***********************************************************************************/
+void DR_Regulation_WakeLatencyActiveReached(void)
+{
+    if(bWakeLatencyPending)
+    {
+        const u32 ulActiveReachedMs = DR_System_GetTickMs() - ulWakeStartTick;
+        
+        sWakeLatency.uiActiveReachedMs = (ulActiveReachedMs > 0xFFFF) ? 0xFFFF : (u16)ulActiveReachedMs;
+        if(sWakeLatency.uiActiveReachedMs > sWakeLatency.uiActiveReachedMaxMs)
+        {
+            sWakeLatency.uiActiveReachedMaxMs = sWakeLatency.uiActiveReachedMs;
+        }
+        
+        bWakeLatencyPending = false;
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Returns the measured wake-up latencies
+\param   none
+\return  sWakeLatency - Pointer to the latency structure (read-only)
+***********************************************************************************/
+const tsWakeLatency* DR_Regulation_GetWakeLatency(void)
+{
+    return &sWakeLatency;
+}
 #endif
\ No newline at end of file
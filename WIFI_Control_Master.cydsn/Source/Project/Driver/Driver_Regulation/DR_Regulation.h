@@ -33,11 +33,21 @@ typedef struct
     bool     bStatus;           //The running status of the chosen PWM module
 }tsPwmData;
 
+typedef struct
+{
+    u16 uiLightOnUs;            //Time from the wake-up interrupt until the PWM outputs were restored
+    u16 uiLightOnMaxUs;         //Maximum of the above time since reset
+    u16 uiActiveReachedMs;      //Time from the wake-up interrupt until the active state was entered
+    u16 uiActiveReachedMaxMs;   //Maximum of the above time since reset
+    u16 uiFastWakeCount;        //Counts how often the outputs were restored in the wake-up interrupt
+}tsWakeLatency;
+
 /***************************** global variables ******************************/
 
 /************************ externally visible functions ***********************/
 void    DR_Regulation_Init(void);
 void    DR_Regulation_ChangeState(teRegulationState eRequestedState, u8 ucOutputIdx);
+void    DR_Regulation_StartFade(u16 uiFadeTimeMs);
 
 bool    DR_Regulation_GetEspResetStatus(void);
 void    DR_Regulation_SetEspResetStatus(bool bReset);
@@ -56,6 +66,11 @@ void DR_Regulation_RxInterruptOnSleep(void);
 
 void DR_Regulation_GetPWMData(uint8_t ucOutputIdx, tsPwmData* psPwmData);
 
+void DR_Regulation_RequestFastWake(u8 ucOutputs);
+bool DR_Regulation_FastWakeOutputs(void);
+void DR_Regulation_WakeLatencyActiveReached(void);
+const tsWakeLatency* DR_Regulation_GetWakeLatency(void);
+
 #ifdef __cplusplus
 }
 #endif    
@@ -0,0 +1,226 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       DR_System.c
+\brief      Millisecond time base on the SysTick timer and the sleep handling
+            which is used when the main task has nothing to do.
+
+***********************************************************************************/
+#include <project.h>
+
+#include "OS_Config.h"
+#include "DR_System.h"
+
+/****************************************** Defines ******************************************************/
+#define SCB_ICSR_REG            (*(reg32 *)0xE000ED04u)     //Interrupt control and state register of the Cortex-M0+
+#define SCB_ICSR_PENDSTSET      0x04000000u                 //SysTick exception is pending
+
+/****************************************** Variables ****************************************************/
+static volatile u32 ulTickMs = 0;
+static u32 ulCyclesPerMs = 0;
+
+static u32 ulIdleCycles = 0;
+static u32 ulWindowStartCycles = 0;
+static u8  ucIdlePercent = 0;
+
+/****************************************** Function prototypes ******************************************/
+static void SysTickCallback(void);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Callback of the SysTick interrupt. Is called every millisecond.
+\return     none
+\param      none
+***********************************************************************************/
+static void SysTickCallback(void)
+{
+    ulTickMs++;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Adds the slept cycles to the idle counter and calculates the idle
+            percentage when the statistic window has elapsed.
+\return     none
+\param      ulSleepCycles - The cycles which were spent in sleep
+***********************************************************************************/
+static void UpdateIdleStatistic(u32 ulSleepCycles)
+{
+    ulIdleCycles += ulSleepCycles;
+
+    u32 ulElapsedCycles = DR_System_GetCycleCount() - ulWindowStartCycles;
+
+    if(ulElapsedCycles >= (ulCyclesPerMs * IDLE_STATISTIC_WINDOW_MS))
+    {
+        /* Divide the elapsed cycles first to avoid an overflow */
+        ucIdlePercent = (u8)(ulIdleCycles / (ulElapsedCycles / 100));
+
+        if(ucIdlePercent > 100)
+        {
+            ucIdlePercent = 100;
+        }
+
+        ulIdleCycles = 0;
+        ulWindowStartCycles += ulElapsedCycles;
+    }
+}
+
+/****************************************** External visible functiones **********************************/
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Starts the SysTick timer with a 1ms interrupt and links the tick
+            counter into a free callback slot.
+\return     none
+\param      none
+***********************************************************************************/
+void DR_System_Init(void)
+{
+    /* Start function initializes the SysTick only once with a 1ms period */
+    CySysTickStart();
+
+    u8 ucCallbackIdx;
+    for(ucCallbackIdx = 0; ucCallbackIdx < CY_SYS_SYST_NUM_OF_CALLBACKS; ucCallbackIdx++)
+    {
+        if(CySysTickGetCallback(ucCallbackIdx) == NULL)
+        {
+            CySysTickSetCallback(ucCallbackIdx, SysTickCallback);
+            break;
+        }
+    }
+
+    ulCyclesPerMs = CySysTickGetReload() + 1;
+    ulWindowStartCycles = DR_System_GetCycleCount();
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the milliseconds since the time base was started.
+\return     ulTickMs - The millisecond tick
+\param      none
+***********************************************************************************/
+u32 DR_System_GetTickMs(void)
+{
+    return ulTickMs;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns a free running CPU cycle counter. The counter is combined
+            from the millisecond tick and the current SysTick value. Should
+            only be used for time differences because it wraps around.
+            With masked interrupts or in an interrupt the reload of the SysTick
+            is detected by the pending tick. Only one missed tick is detected.
+\return     u32 - The current cycle count
+\param      none
+***********************************************************************************/
+u32 DR_System_GetCycleCount(void)
+{
+    u32 ulTickRead;
+    u32 ulTick;
+    u32 ulValue;
+
+    /* Read again when the tick interrupt occured in between */
+    do
+    {
+        ulTickRead = ulTickMs;
+        ulTick = ulTickRead;
+        ulValue = CySysTickGetValue();
+
+        /* The tick isn't served yet. The value has reloaded before or after the
+           first read, so it is read again behind the reload */
+        if(SCB_ICSR_REG & SCB_ICSR_PENDSTSET)
+        {
+            ulValue = CySysTickGetValue();
+            ulTick++;
+        }
+    }while(ulTickRead != ulTickMs);
+
+    /* SysTick is a down counter */
+    return (ulTick * ulCyclesPerMs) + (ulCyclesPerMs - 1 - ulValue);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the CPU cycles of one millisecond tick.
+\return     ulCyclesPerMs - Cycles per millisecond
+\param      none
+***********************************************************************************/
+u32 DR_System_GetCyclesPerMs(void)
+{
+    return ulCyclesPerMs;
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Converts a cycle difference into microseconds.
+\return     u32 - The time in us
+\param      ulCycles - The cycles which shall be converted
+***********************************************************************************/
+u32 DR_System_CyclesToUs(u32 ulCycles)
+{
+    return ulCycles / (ulCyclesPerMs / 1000);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Puts the CPU into sleep until the next interrupt (at least the next
+            millisecond tick). Has to be called within a critical section after
+            the event queue was checked to be empty. The pending interrupt wakes
+            the CPU although the interrupts are masked and is served when the
+            critical section is left.
+\return     none
+\param      none
+***********************************************************************************/
+void DR_System_EnterIdleSleep(void)
+{
+    const u32 ulSleepStart = DR_System_GetCycleCount();
+
+    /* Wait for interrupt */
+    CySysPmSleep();
+
+    /* A tick which woke up the CPU is pending and already part of the cycle count */
+    const u32 ulSleepCycles = DR_System_GetCycleCount() - ulSleepStart;
+
+    UpdateIdleStatistic(ulSleepCycles);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Returns the idle percentage of the last statistic window.
+\return     ucIdlePercent - 0..100% of the time the CPU was sleeping
+\param      none
+***********************************************************************************/
+u8 DR_System_GetIdlePercent(void)
+{
+    return ucIdlePercent;
+}
@@ -0,0 +1,42 @@
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+
+\file       DR_System.h
+\brief      System time base and idle handling of the main task
+
+***********************************************************************************/
+#ifndef _DR_SYSTEM_H_
+#define _DR_SYSTEM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+
+/***************************** defines / macros ******************************/
+#define IDLE_STATISTIC_WINDOW_MS        1000    //Window in milliseconds for the idle percentage calculation
+
+/****************************** type definitions *****************************/
+/***************************** global variables ******************************/
+
+/************************ externally visible functions ***********************/
+void    DR_System_Init(void);
+u32     DR_System_GetTickMs(void);
+u32     DR_System_GetCycleCount(void);
+u32     DR_System_GetCyclesPerMs(void);
+u32     DR_System_CyclesToUs(u32 ulCycles);
+
+void    DR_System_EnterIdleSleep(void);
+u8      DR_System_GetIdlePercent(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_DR_SYSTEM_H_
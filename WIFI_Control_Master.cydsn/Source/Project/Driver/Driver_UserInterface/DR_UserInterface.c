@@ -10,6 +10,9 @@
 
 #include "DR_UserInterface.h"
 #include "DR_ErrorDetection.h"
+#include "DR_Regulation.h"
+#include "DR_System.h"
+#include "OS_Config.h"
 #include "OS_EventManager.h"
 #include "OS_ErrorDebouncer.h"
 #include "OS_ErrorHandler.h"
@@ -19,13 +22,101 @@
 #include "Aom_System.h"
 #include "IR_Decoder.h"
 #include "IR_Commands.h"
+#include "AutomaticMode.h"
+#include "Scene.h"
+#include "Profiler.h"
+#include "EventQueue.h"
 
 /****************************************** Defines ******************************************************/
+#define PIR_DEBOUNCE_MS         200     //Edges within this time after a motion start are ignored
    
 /****************************************** Variables ****************************************************/
 static tsIR_Data sIR_Data;
 
+/* Hand-off of the PIR edges from the interrupt to the main loop. The counters
+   are only written by one side each. Thus no critical section is needed */
+static volatile u8   ucMotionEdgeCnt = 0;       //Written by the ISR
+static volatile u8   ucMotionEdgeAck = 0;       //Written by the main loop
+static volatile u8   ucMotionStartCnt = 0;      //Accepted rising edges. Written by the ISR
+static volatile bool bMotionLevel = false;      //Level of the PIR pin at the last accepted edge
+static volatile bool bMotionEdgeFiltered = false;   //An edge was ignored within the debounce time
+static volatile u32  ulMotionStartTick = (u32)-PIR_DEBOUNCE_MS;   //Time stamp of the last accepted rising edge
+static u8 ucMotionStartAck = 0;
+
 /****************************************** Function prototypes ******************************************/
+static void TakeMotionLevel(bool bLevel);
+static void ResyncMotionLevel(void);
+
+
+/****************************************** local functions *********************************************/
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Takes over an accepted level of the PIR pin. A high level is a motion
+         start. In standby the fast wake-up of the outputs is requested when
+         the automatic mode would switch on the light. The main loop is
+         notified with an event when it has taken all previous edges.
+         Called from the interrupt or within a critical section.
+\param   bLevel - The level of the PIR pin
+\return  none
+***********************************************************************************/
+static void TakeMotionLevel(bool bLevel)
+{
+    bMotionLevel = bLevel;
+    
+    if(bLevel)
+    {
+        ulMotionStartTick = DR_System_GetTickMs();
+        ucMotionStartCnt++;
+        
+        /* Light up the outputs of the automatic mode before the state machine wakes up. Only armed in standby */
+        const u8 ucLightOutputs = AutomaticMode_GetMotionLightOutputs();
+        if(ucLightOutputs)
+        {
+            DR_Regulation_RequestFastWake(ucLightOutputs);
+        }
+    }
+    
+    /* A pending notification takes this edge too */
+    const bool bNotify = (ucMotionEdgeCnt == ucMotionEdgeAck);
+    ucMotionEdgeCnt++;
+    
+    if(bNotify)
+    {
+        EventQueue_PostToOs(eEvtAutomaticMode_MotionEdge, 0, 0);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Takes over the level of the PIR pin when edges were ignored within the
+         debounce time and the level differs from the last accepted one.
+\param   none
+\return  none
+***********************************************************************************/
+static void ResyncMotionLevel(void)
+{
+    const u8 ucCriticalSection = EnterCritical();
+    
+    if(bMotionEdgeFiltered)
+    {
+        bMotionEdgeFiltered = false;
+        
+        const bool bLevel = HAL_IO_ReadDigitalSense(eSensePIR);
+        if(bLevel != bMotionLevel)
+        {
+            TakeMotionLevel(bLevel);
+        }
+    }
+    
+    LeaveCritical(ucCriticalSection);
+}
+
+/****************************************** External visible functiones **********************************/
 static void IR_Decoder_TimerIRQ(void);
 static void IR_Decoder_InputIRQ(void);
 static void IR_Decoder_Clear(void);
@@ -43,6 +134,8 @@ static void IR_Decoder_Clear(void);
 ***********************************************************************************/
 static void IR_Decoder_TimerIRQ(void)
 {
+    PROFILE_START(eProfile_InfraredTimerIsr);
+    
     //Variable to store the counter status register. Value is used to determine the event
     //which caused the interrupt (terminal count or capture).
     uint32_t ulIsrSource = Timer_IR_GetInterruptSource();
@@ -78,8 +171,10 @@ static void IR_Decoder_TimerIRQ(void)
         teNEC_Commands eCmd = IR_Commands_GetCommand(sIR_Data.ucCommand, uiAddress);
         
         /* New data received. Create event to handle the change */
-        OS_EVT_PostEvent(eEvtIR_CmdReceived, eCmd,0);
+        EventQueue_PostToOs(eEvtIR_CmdReceived, eCmd,0);
     }
+    
+    PROFILE_STOP(eProfile_InfraredTimerIsr);
 }
 
 //********************************************************************************
@@ -218,29 +313,158 @@ void DR_UI_SwitchOffHeartBeatLED(void)
 /*!
 \author  KraemerE
 \date    06.05.2021
-\brief   Checks first if a motion sensor is used. Afterwards the input pin of the
-         sensor is read. When a HIGH level was detected the an event for reseting
-         the burning time is created.
+\brief   Interrupt service request for the PIR gpio. Checks first if a motion
+         sensor is used. Edges within the debounce time after a motion start
+         are ignored and don't reach the main loop. Their level is taken over
+         by DR_UI_MotionDebounceTick when the debounce time has elapsed.
+         Otherwise the level of the sensor pin is taken over with the edge.
 \param   none
-\return  psAutoVal->bMotionDetected - True for High-State and false for LOW-State
+\return  none
 ***********************************************************************************/
-void DR_UI_CheckSensorForMotion(void)
+void DR_UI_MotionSensorIRQ(void)
 {
-    /* Read PIR out for possible motion detection */                        
-    const tRegulationValues* psReg = Aom_Regulation_GetRegulationValuesPointer();                        
-    tsAutomaticModeValues* psAutoVal = Aom_System_GetAutomaticModeValuesStruct();
-        
-    if(psReg->sUserTimerSettings.bMotionDetectOnOff)
+    const tRegulationValues* psReg = Aom_Regulation_GetRegulationValuesPointer();
+    
+    if(psReg->sUserTimerSettings.bMotionDetectOnOff == false)
+    {
+        return;
+    }
+    
+    if((DR_System_GetTickMs() - ulMotionStartTick) < PIR_DEBOUNCE_MS)
+    {
+        bMotionEdgeFiltered = true;
+        return;
+    }
+    
+    TakeMotionLevel(HAL_IO_ReadDigitalSense(eSensePIR));
+}
+
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Takes over the level of the PIR pin after the debounce time when edges
+         were ignored. Edges whose notification wasn't taken are notified
+         again. Shall be called periodically while the motion sensor is in use.
+\param   none
+\return  none
+***********************************************************************************/
+void DR_UI_MotionDebounceTick(void)
+{
+    if(bMotionEdgeFiltered && (DR_System_GetTickMs() - ulMotionStartTick) >= PIR_DEBOUNCE_MS)
+    {
+        ResyncMotionLevel();
+    }
+    
+    DR_UI_ResumeMotionEdges();
+}
+
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    19.10.2026
+\brief   Posts the notification of the PIR edges again when edges weren't taken
+         by the main loop. The interrupt only notifies when all previous edges
+         were taken. A notification which got lost in a state transition would
+         block all further ones otherwise. A second notification is harmless
+         because the edges are only taken once.
+\param   none
+\return  none
+***********************************************************************************/
+void DR_UI_ResumeMotionEdges(void)
+{
+    const u8 ucCriticalSection = EnterCritical();
+    
+    if(ucMotionEdgeCnt != ucMotionEdgeAck)
     {
-        /* Check if PIR has detected a change */
-        psAutoVal->bMotionDetected = HAL_IO_ReadDigitalSense(eSensePIR);
+        EventQueue_PostToOs(eEvtAutomaticMode_MotionEdge, 0, 0);
+    }
+    
+    LeaveCritical(ucCriticalSection);
+}
+
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Ends the debounce time before the deep sleep. The tick counter stops
+         in the deep sleep, so the debounce time wouldn't elapse and the edge
+         which wakes up the CPU would be ignored. The level of ignored edges is
+         taken over before.
+\param   none
+\return  none
+***********************************************************************************/
+void DR_UI_RearmMotionDebounce(void)
+{
+    ulMotionStartTick = DR_System_GetTickMs() - PIR_DEBOUNCE_MS;
+    ResyncMotionLevel();
+}
+
 
-        if(psAutoVal->bMotionDetected)
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Takes over the PIR edges from the interrupt. The motion state of the
+         automatic mode follows the pin level. Edges which occur meanwhile are
+         taken in the same call.
+\param   none
+\return  bMotionChanged - True when a motion has started or ended
+***********************************************************************************/
+bool DR_UI_TakeMotionEdges(void)
+{
+    tsAutomaticModeValues* psAutoVal = Aom_System_GetAutomaticModeValuesStruct();
+    bool bMotionChanged = false;
+    u8 ucEdgeCnt;
+    
+    do
+    {
+        ucEdgeCnt = ucMotionEdgeCnt;
+        
+        const u8 ucStartCnt = ucMotionStartCnt;
+        const bool bLevel = bMotionLevel;
+        
+        if(ucStartCnt != ucMotionStartAck)
         {
-            /* Reset "ON" timeout */
-            OS_EVT_PostEvent(eEvtAutomaticMode_ResetBurningTimeout,0 ,0);
+            ucMotionStartAck = ucStartCnt;
+            bMotionChanged = true;
         }
-    }    
+        
+        if(bLevel != psAutoVal->bMotionDetected)
+        {
+            psAutoVal->bMotionDetected = bLevel;
+            bMotionChanged = true;
+            AutomaticMode_RequestEvaluation(false);
+        }
+        
+        ucMotionEdgeAck = ucEdgeCnt;
+    }
+    while(ucEdgeCnt != ucMotionEdgeCnt);
+    
+    return bMotionChanged;
+}
+
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Enables the PIR interrupt on both edges and takes over the current
+         level of the pin. A motion which has started before isn't lost.
+\param   none
+\return  none
+***********************************************************************************/
+void DR_UI_EnableMotionInterrupt(void)
+{
+    const u8 ucCriticalSection = EnterCritical();
+    
+    Pin_PIR_SetInterruptMode(Pin_PIR_0_INTR, Pin_PIR_INTR_BOTH);
+    DR_UI_MotionSensorIRQ();
+    
+    LeaveCritical(ucCriticalSection);
 }
 
 //********************************************************************************
@@ -309,12 +533,17 @@ void DR_UI_InfraredCmd(uint8_t uiIrCmd)
             break;
         }
         
+        /* Keys which recall a scene */
+        #define SCENE_KEY(eKey, ucSceneIdx) case eKey: { Scene_Recall(ucSceneIdx); break; }
+        USER_SCENE_IR_LIST
+        #undef SCENE_KEY
+        
         default:
             break;
     }
     
     if(uiParam != eEvtParam_None)
     {
-        OS_EVT_PostEvent(eEvtNewRegulationValue, uiParam, ulParam);
+        EventQueue_PostToOs(eEvtNewRegulationValue, uiParam, ulParam);
     }
 }
\ No newline at end of file
@@ -31,7 +31,12 @@ void    DR_UI_ToggleErrorLED(void);
 void    DR_UI_ToggleHeartBeatLED(void);
 void    DR_UI_SwitchOffHeartBeatLED(void);
 
-void    DR_UI_CheckSensorForMotion(void);
+void    DR_UI_MotionSensorIRQ(void);
+bool    DR_UI_TakeMotionEdges(void);
+void    DR_UI_EnableMotionInterrupt(void);
+void    DR_UI_MotionDebounceTick(void);
+void    DR_UI_ResumeMotionEdges(void);
+void    DR_UI_RearmMotionDebounce(void);
 
 void    DR_UI_InfraredInputIRQ(void);
 void    DR_UI_InfraredCmd(uint8_t uiIrCmd);
@@ -15,11 +15,17 @@
 #include "DR_Measure.h"
 #include "OS_Config.h"
 #include "OS_EventManager.h"
+#include "EventQueue.h"
+#include "TimerTable.h"
+#include "SunTime.h"
+#include "Occupancy.h"
 
 /***************************** defines / macros ******************************/
-#define NIGHT_MODE_START        22
+#define NIGHT_MODE_START        22      //Night mode slot without an active sun timer
 #define NIGHT_MODE_STOP         5
 
+#define ALL_OUTPUTS             ((0x01 << DRIVE_OUTPUTS) - 1)
+
 /************************ local data type definitions ************************/
 typedef bool (*pbFunction)(void);
 
@@ -43,74 +49,76 @@ tsAutomaticState sAutomaticState =
     .pFctState = NULL,
 };
 
+static bool bEvaluationPending = true;  //An input of the automatic mode has changed since the last evaluation
+static bool bOutputsPosted = false;     //False when the light state of all outputs has to be posted again
+static bool bLightEnabled = OFF;        //Result of the last evaluation
+static u8   ucPostedOutputs = 0;        //Switched on outputs of the last posted light state
+static bool bPostedNightSlot = false;   //Night mode time slot of the last posted light state
+static u8   aucPostedBrightness[DRIVE_OUTPUTS]; //Timer table brightness of the last posted light state
+
 
 /****************************** local functions ******************************/
 //********************************************************************************
 /*!
 \author     Kraemer E
 \date       17.06.2021
-\brief      Posts an regulation event in dependancy of the given light state.
+\brief      Posts a regulation event for each output whose light state differs
+            from the last posted one. A switched on output is also posted when
+            its requested brightness has changed by the timer table or the night
+            mode time slot. A pending event of the same output is overwritten
+            with the new state.
 \return     none
-\param      bEnableLight - True when regulation shall be started or false when stopped
+\param      ucLightOutputs - Bit mask of the outputs which shall be switched on
 ***********************************************************************************/
-static inline void PostRegulationEvt(bool bEnableLight)
+static inline void PostRegulationEvt(u8 ucLightOutputs)
 {
+    const tsAutomaticModeValues* psAutoValues = Aom_System_GetAutomaticModeValuesStruct();
+    u8 ucChangedOutputs = bOutputsPosted ? (ucLightOutputs ^ ucPostedOutputs) : ALL_OUTPUTS;
+    
+    /* The brightness of a switched on output is only taken over with a new start event */
+    for(u8 ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
+    {
+        if(psAutoValues->aucTimerTableBrightness[ucOutputIdx] != aucPostedBrightness[ucOutputIdx]
+            || psAutoValues->bInNightModeTimeSlot != bPostedNightSlot)
+        {
+            ucChangedOutputs |= (ucLightOutputs & (0x01 << ucOutputIdx));
+        }
+        aucPostedBrightness[ucOutputIdx] = psAutoValues->aucTimerTableBrightness[ucOutputIdx];
+    }
+    bPostedNightSlot = psAutoValues->bInNightModeTimeSlot;
+    
     /* Start or stop the regulation in dependancy of the automatic mode */
-    teEventParam eEvtParam = (bEnableLight == true) ? eEvtParam_RegulationStart : eEvtParam_RegulationStop;
     for(u8 ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
-    {                
-        OS_EVT_PostEvent(eEvtNewRegulationValue, eEvtParam, ucOutputIdx);
+    {
+        if(ucChangedOutputs & (0x01 << ucOutputIdx))
+        {
+            teEventParam eEvtParam = (ucLightOutputs & (0x01 << ucOutputIdx)) ? eEvtParam_RegulationStart : eEvtParam_RegulationStop;
+            EventQueue_PostEvent(eEvtNewRegulationValue, eEvtParam, ucOutputIdx, eEvtPost_LatestWins);
+        }
     }
+    
+    ucPostedOutputs = ucLightOutputs;
+    bOutputsPosted = true;
 }
 
 //********************************************************************************
 /*!
 \author     Kraemer E
-\date       01.12.2019
-\fn         IsCurrentTimeInActiveTimeSlot
-\brief      Checks if the current time is in the specific automatic on time
-\return     bInSlot - Returns true when in time slot
-\param      ucHours - The current hour
-\param      ucMin - The current minutes
+\date       19.10.2026
+\fn         GetNightModeTimeSlot
+\brief      Returns the night mode slot. The active sun timer sets it from dusk
+            until dawn. Otherwise the fixed slot is used.
+\return     none
+\param      puiStartMin - Minute of the day when the slot starts
+\param      puiStopMin - Minute of the day when the slot ends
 ***********************************************************************************/
-static bool IsCurrentTimeInActiveTimeSlot(u8 ucHours, u8 ucMin)
+static void GetNightModeTimeSlot(u16* puiStartMin, u16* puiStopMin)
 {
-    bool bInSlot = false;
-    u8 ucSlotsFound = 0;
-    
-    tRegulationValues sRegulationValues;       
-    Aom_Regulation_GetRegulationValues(&sRegulationValues);
-
-    for(u8 ucTimerIdx = 0; ucTimerIdx < USER_TIMER_AMOUNT; ucTimerIdx++)
-    {
-        if(sRegulationValues.sUserTimerSettings.ucSetTimerBinary  & (0x01 << ucTimerIdx))
-        {       
-            if((ucHours == sRegulationValues.sUserTimerSettings.sTimer[ucTimerIdx].ucHourSet) && (ucMin >= sRegulationValues.sUserTimerSettings.sTimer[ucTimerIdx].ucMinSet))
-            {
-                ucSlotsFound++;
-            }
-            else if(ucHours > sRegulationValues.sUserTimerSettings.sTimer[ucTimerIdx].ucHourSet)
-            {
-                ucSlotsFound++;
-            }
-        
-            if(ucHours == sRegulationValues.sUserTimerSettings.sTimer[ucTimerIdx].ucHourClear && ucMin >= sRegulationValues.sUserTimerSettings.sTimer[ucTimerIdx].ucMinClear)
-            {
-                ucSlotsFound--;
-            }
-            else if(ucHours > sRegulationValues.sUserTimerSettings.sTimer[ucTimerIdx].ucHourClear)
-            {
-                ucSlotsFound--;
-            }
-        }
-    }
-
-    if(ucSlotsFound > 0)
+    if(Aom_Time_GetDuskToDawn(puiStartMin, puiStopMin) == false)
     {
-        bInSlot = true;
+        *puiStartMin = NIGHT_MODE_START * 60;
+        *puiStopMin = NIGHT_MODE_STOP * 60;
     }
-      
-    return bInSlot;
 }
 
 //********************************************************************************
@@ -119,30 +127,45 @@ static bool IsCurrentTimeInActiveTimeSlot(u8 ucHours, u8 ucMin)
 \date       21.08.2020
 \fn         IsCurrentTimeInNightModeTimeSlot
 \brief      Checks if the current time is in the specific night mode time slot
-\return     bInSlot - Returns true when in time slot
-\param      ucHours - The current hour
+\return     bool - Returns true when in time slot
+\param      uiMinOfDay - The current minute of the day
 ***********************************************************************************/
-static bool IsCurrentTimeInNightModeTimeSlot(u8 ucHours)
+static bool IsCurrentTimeInNightModeTimeSlot(u16 uiMinOfDay)
 {
-    bool bInSlot = false;
-    u8 ucSlotsFound = 0;
-      
-    if(ucHours >= NIGHT_MODE_START)
+    u16 uiStartMin;
+    u16 uiStopMin;
+    GetNightModeTimeSlot(&uiStartMin, &uiStopMin);
+    
+    /* The night mode slot continues over midnight when it ends before its start */
+    if(uiStartMin > uiStopMin)
     {
-        ucSlotsFound++;
+        return (uiMinOfDay >= uiStartMin || uiMinOfDay < uiStopMin);
     }
+    
+    return (uiMinOfDay >= uiStartMin && uiMinOfDay < uiStopMin);
+}
 
-    if(ucHours >= NIGHT_MODE_STOP)
-    {
-        ucSlotsFound--;
-    }
 
-    if(ucSlotsFound > 0)
-    {
-        bInSlot = true;
-    }
-      
-    return bInSlot;
+//********************************************************************************
+/*!
+\author     Kraemer E
+\date       18.10.2026
+\fn         GetMinutesToNightModeEdge
+\brief      Calculates the minutes until the night mode slot starts or ends.
+\return     u16 - Minutes until the next night mode edge (1..MINUTES_PER_DAY)
+\param      uiMinOfDay - The current minute of the day
+***********************************************************************************/
+static u16 GetMinutesToNightModeEdge(u16 uiMinOfDay)
+{
+    u16 uiStartMin;
+    u16 uiStopMin;
+    GetNightModeTimeSlot(&uiStartMin, &uiStopMin);
+    
+    const u16 uiEdgeMin = IsCurrentTimeInNightModeTimeSlot(uiMinOfDay) ? uiStopMin : uiStartMin;
+    
+    u16 uiDistance = (uiEdgeMin + MINUTES_PER_DAY - uiMinOfDay) % MINUTES_PER_DAY;
+    
+    return uiDistance ? uiDistance : MINUTES_PER_DAY;
 }
 
 
@@ -165,8 +188,6 @@ static bool StateAutomaticMode_1(void)
     const tsAutomaticModeValues* psAutoValues = Aom_System_GetAutomaticModeValuesStruct();    
     bEnableLight = psAutoValues->bInUserTimerSlot;
     
-    PostRegulationEvt(bEnableLight); 
-    
     return bEnableLight;
 }
 
@@ -196,8 +217,6 @@ static bool StateAutomaticMode_2(void)
         bEnableLight = true;
     }
     
-    PostRegulationEvt(bEnableLight); 
-    
     return bEnableLight;
 }
 
@@ -221,8 +240,6 @@ static bool StateAutomaticMode_3(void)
     const tsAutomaticModeValues* psAutoValues = Aom_System_GetAutomaticModeValuesStruct();    
     bEnableLight = (psAutoValues->bMotionDetected || psAutoValues->slBurningTimeMs);
     
-    PostRegulationEvt(bEnableLight);    
-    
     return bEnableLight;
 }
 
@@ -234,28 +251,71 @@ static bool StateAutomaticMode_3(void)
 /*!
 \author  KraemerE
 \date    21.08.2020
-\brief   Calls the linked automatic-function. Checks afterwards for the next state.
+\brief   Calls the linked automatic-function when an input has changed since
+         the last call. Regulation events are only posted for the outputs whose
+         light state has changed.
 \param   none
 \return  bLightEnabled - Returns the light on/off state
 ***********************************************************************************/
 bool AutomaticMode_Handler(void)
 {    
-    bool bLightEnabled = OFF;
+    /* The inputs are unchanged. So is the light state */
+    if(bEvaluationPending == false)
+    {
+        return bLightEnabled;
+    }
+    
+    bEvaluationPending = false;
+    bLightEnabled = OFF;
     
     /* Call the actual standby function */
     if(sAutomaticState.pFctState)
     {
         bLightEnabled = sAutomaticState.pFctState();
+        
+        /* In the time slots only the outputs of the active timers are switched on */
+        u8 ucLightOutputs = 0;
+        if(bLightEnabled)
+        {
+            const tsAutomaticModeValues* psAutoValues = Aom_System_GetAutomaticModeValuesStruct();
+            ucLightOutputs = (sAutomaticState.eCurrentState == eStateAutomaticMode_3) ? ALL_OUTPUTS : psAutoValues->ucTimerSlotOutputs;
+        }
+        
+        PostRegulationEvt(ucLightOutputs);
     }
     /* State active reached successfully */
     else
     {
-        sAutomaticState.eCurrentState = eStateDisabled;        
+        sAutomaticState.eCurrentState = eStateDisabled;
+        
+        /* The outputs can be switched manually. The next automatic mode posts all outputs */
+        bOutputsPosted = false;
     }
     return bLightEnabled;
 }
 
 
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\brief   Marks an input of the automatic mode as changed. The automatic mode is
+         evaluated with the next call of the handler.
+\param   bPostAllOutputs - True when the light state of all outputs shall be
+                           posted again even when it hasn't changed
+\return  none
+***********************************************************************************/
+void AutomaticMode_RequestEvaluation(bool bPostAllOutputs)
+{
+    bEvaluationPending = true;
+    
+    if(bPostAllOutputs)
+    {
+        bOutputsPosted = false;
+    }
+}
+
+
 //********************************************************************************
 /*!
 \author  KraemerE
@@ -266,6 +326,8 @@ bool AutomaticMode_Handler(void)
 ***********************************************************************************/
 void AutomaticMode_ChangeState(teAutomaticState eRequestedState)
 {
+    const pbFunction pFctPrevious = sAutomaticState.pFctState;
+    
     /* Change callback for dependent state */
     switch(eRequestedState)
     {
@@ -297,6 +359,12 @@ void AutomaticMode_ChangeState(teAutomaticState eRequestedState)
         default:
             break;
     } 
+    
+    /* The light state has to be evaluated with the new mode */
+    if(sAutomaticState.pFctState != pFctPrevious)
+    {
+        bEvaluationPending = true;
+    }
 }
 
 
@@ -344,6 +412,12 @@ void AutomaticMode_Tick(u16 uiMsTick)
             slBurningTimeCopy = 0;
         }        
         
+        /* The burning time has expired */
+        if(slBurningTimeCopy == 0)
+        {
+            bEvaluationPending = true;
+        }
+        
         /* Enter critical section and overwrite the burning time value */
         const u8 ucCriticalSection = EnterCritical();     
         
@@ -358,24 +432,34 @@ void AutomaticMode_Tick(u16 uiMsTick)
 \author  KraemerE
 \date    09.09.2020
 \fn      AutomaticMode_ResetBurningTimeout
-\brief   Resets the burning time value from the automatic mode structure
+\brief   Resets the burning time value from the automatic mode structure.
+         The burning time is learned from the gaps between the motions.
 \param   none
 \return  none
 ***********************************************************************************/
 void AutomaticMode_ResetBurningTimeout(void)
 {
     tsAutomaticModeValues* psAutomaticModeValues = Aom_System_GetAutomaticModeValuesStruct();
+    const tRegulationValues* psRegulationValues = Aom_Regulation_GetRegulationValuesPointer();
+    
+    /* Learn the gap and get the burning time of the current hour */
+    const u8 ucBurningTime = Occupancy_MotionChanged(psAutomaticModeValues->bMotionDetected,
+                                                     psRegulationValues->sUserTimerSettings.ucBurningTime);
     
     #if ENABLE_FAST_STANDBY
         s32 slBurningTimeMs = 15000;    //15 seconds as burning intervall
+        (void)ucBurningTime;
     #else
-        const tRegulationValues* psRegulationValues = Aom_Regulation_GetRegulationValuesPointer();
-        
-        /* Convert minutes value into milliseconds value (x 60.000 or bitshift by 16 (=65.536) */
-        s32 slBurningTimeMs = psRegulationValues->sUserTimerSettings.ucBurningTime << 16;
-        slBurningTimeMs -= 5536;
+        /* Convert minutes value into milliseconds value */
+        s32 slBurningTimeMs = (s32)ucBurningTime * 60000;
     #endif
         
+    /* A restart of a running burning time doesn't change the light state */
+    if(psAutomaticModeValues->slBurningTimeMs == 0)
+    {
+        bEvaluationPending = true;
+    }
+    
     /* Enter critical section and overwrite burning time variable */
     const u8 ucCriticalSection = EnterCritical();
     psAutomaticModeValues->slBurningTimeMs = slBurningTimeMs;
@@ -408,13 +492,110 @@ bool AutomaticMode_LeaveStandbyMode(void)
     return bLeaveStandbyMode;    
 }
 
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\fn      AutomaticMode_GetMotionLightOutputs
+\brief   Checks which outputs a detected motion switches on in the currently
+         used automatic mode. Same decision as in the automatic mode states
+         and the handler but without posting regulation events. Can be called
+         in interrupt context.
+\param   none
+\return  ucLightOutputs - Bit per output which a motion would switch on
+***********************************************************************************/
+u8 AutomaticMode_GetMotionLightOutputs(void)
+{
+    u8 ucLightOutputs = 0;
+    
+    const tsAutomaticModeValues* psAutoValues = Aom_System_GetAutomaticModeValuesStruct();
+    
+    if(sAutomaticState.eCurrentState == eStateAutomaticMode_3)
+    {
+        ucLightOutputs = ALL_OUTPUTS;
+    }
+    else if(sAutomaticState.eCurrentState == eStateAutomaticMode_2 && psAutoValues->bInUserTimerSlot)
+    {
+        ucLightOutputs = psAutoValues->ucTimerSlotOutputs;
+    }
+    
+    return ucLightOutputs;
+}
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\fn      AutomaticMode_LightOnBySchedule
+\brief   Checks if the user timer slot alone switches on the light in the
+         currently used automatic mode.
+\param   none
+\return  bool - True when the light is switched on by the time slot
+***********************************************************************************/
+bool AutomaticMode_LightOnBySchedule(void)
+{
+    const tsAutomaticModeValues* psAutoValues = Aom_System_GetAutomaticModeValuesStruct();
+    
+    return (sAutomaticState.eCurrentState == eStateAutomaticMode_1 && psAutoValues->bInUserTimerSlot);
+}
+
+//********************************************************************************
+/*!
+\author  KraemerE
+\date    18.10.2026
+\fn      AutomaticMode_GetMinutesToNextTransition
+\brief   Calculates the minutes from the current time until the next edge of a
+         user timer slot, of the timer table or of the night mode slot. Only the edges which are
+         used by the current automatic mode are taken into account.
+\param   none
+\return  uiMinutes - Minutes until the next transition. 0 when there is none.
+***********************************************************************************/
+u16 AutomaticMode_GetMinutesToNextTransition(void)
+{
+    const tRegulationValues* psRegVal = Aom_Regulation_GetRegulationValuesPointer();
+    const tsCurrentTime* psTime = Aom_Time_GetCurrentTime();
+    u16 uiMinutes = 0;
+    
+    if(psRegVal->sUserTimerSettings.bAutomaticModeActive == false
+        || sAutomaticState.eCurrentState == eStateDisabled)
+    {
+        return 0;
+    }
+    
+    /* Time slots aren't used in automatic mode 3 */
+    if(sAutomaticState.eCurrentState != eStateAutomaticMode_3)
+    {
+        uiMinutes = Aom_Time_GetMinutesToNextScheduleEdge(psTime->ucHours, psTime->ucMinutes);
+        
+        const u16 uiTableMinutes = TimerTable_GetMinutesToNextEdge(Aom_Time_GetWeekday(), (psTime->ucHours * 60) + psTime->ucMinutes);
+        
+        if(uiTableMinutes && (uiMinutes == 0 || uiTableMinutes < uiMinutes))
+        {
+            uiMinutes = uiTableMinutes;
+        }
+    }
+    
+    if(psRegVal->bNightModeOnOff && psTime->ucHours < 24 && psTime->ucMinutes < 60)
+    {
+        const u16 uiNightMinutes = GetMinutesToNightModeEdge((psTime->ucHours * 60) + psTime->ucMinutes);
+        
+        if(uiMinutes == 0 || uiNightMinutes < uiMinutes)
+        {
+            uiMinutes = uiNightMinutes;
+        }
+    }
+    
+    return uiMinutes;
+}
+
 //********************************************************************************
 /*!
 \author  KraemerE
 \date    11.05.2021
 \brief   Checks if an automatic mode is active and checks if the current time
          is in the user defined time slot. Also checks if the night mode shall be
-         switched on.
+         switched on. A changed time slot, timer table brightness or night mode
+         time slot requests a new evaluation.
 \param   none
 \return  none
 ***********************************************************************************/
@@ -428,12 +609,46 @@ void AutomaticMode_TimeUpdated(void)
     /* Check if automatic mode is enabled. Otherwise handling isn't relevant */
     if(psRegVal->sUserTimerSettings.bAutomaticModeActive)
     {
-        psAutoMode->bInUserTimerSlot = IsCurrentTimeInActiveTimeSlot(psTime->ucHours, psTime->ucMinutes);
+        /* The sun times change once per day. The dusk to dawn slot is part of the schedule */
+        if(SunTime_Update())
+        {
+            Aom_Time_CompileUserTimerSchedule();
+        }
+        
+        /* The user timers are compiled into a minute schedule when they are changed. They switch all outputs */
+        const bool bInUserTimerSlot = Aom_Time_IsInUserTimerSlot(psTime->ucHours, psTime->ucMinutes);
+        
+        /* The timer table switches only the outputs of its active entries */
+        u8 aucPreviousBrightness[DRIVE_OUTPUTS];
+        memcpy(aucPreviousBrightness, psAutoMode->aucTimerTableBrightness, sizeof(aucPreviousBrightness));
+        
+        const u8 ucTableOutputs = TimerTable_GetOutputs(Aom_Time_GetWeekday(), (psTime->ucHours * 60) + psTime->ucMinutes,
+                                                        psAutoMode->aucTimerTableBrightness);
         
-        /* Check if night mode is active and in night mode time slot */
-        if(psRegVal->bNightModeOnOff)
+        const u8 ucTimerSlotOutputs = bInUserTimerSlot ? ALL_OUTPUTS : ucTableOutputs;
+        
+        if(ucTimerSlotOutputs != psAutoMode->ucTimerSlotOutputs)
         {
-            psAutoMode->bInNightModeTimeSlot = IsCurrentTimeInNightModeTimeSlot(psTime->ucHours);
+            psAutoMode->ucTimerSlotOutputs = ucTimerSlotOutputs;
+            psAutoMode->bInUserTimerSlot = (ucTimerSlotOutputs != 0);
+            bEvaluationPending = true;
+        }
+        
+        if(memcmp(aucPreviousBrightness, psAutoMode->aucTimerTableBrightness, sizeof(aucPreviousBrightness)))
+        {
+            bEvaluationPending = true;
+        }
+        
+        /* Check if night mode is active and in night mode time slot. The slot follows dusk and dawn with the minute */
+        if(psRegVal->bNightModeOnOff && psTime->ucHours < 24 && psTime->ucMinutes < 60)
+        {
+            const bool bInNightModeTimeSlot = IsCurrentTimeInNightModeTimeSlot((psTime->ucHours * 60) + psTime->ucMinutes);
+            
+            if(bInNightModeTimeSlot != psAutoMode->bInNightModeTimeSlot)
+            {
+                psAutoMode->bInNightModeTimeSlot = bInNightModeTimeSlot;
+                bEvaluationPending = true;
+            }
         }                  
     }
 }
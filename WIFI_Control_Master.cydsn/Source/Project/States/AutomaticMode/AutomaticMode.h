@@ -31,10 +31,14 @@ typedef enum
 /************************ externally visible functions ***********************/
 void AutomaticMode_ChangeState(teAutomaticState eRequestedState);
 bool AutomaticMode_Handler(void);
+void AutomaticMode_RequestEvaluation(bool bPostAllOutputs);
 teAutomaticState AutomaticMode_GetAutomaticState(void);
 void AutomaticMode_Tick(u16 uiMsTick);
 void AutomaticMode_ResetBurningTimeout(void);
 bool AutomaticMode_LeaveStandbyMode(void);
+u8 AutomaticMode_GetMotionLightOutputs(void);
+bool AutomaticMode_LightOnBySchedule(void);
+u16 AutomaticMode_GetMinutesToNextTransition(void);
 void AutomaticMode_TimeUpdated(void);
 
 #endif // _AUTOMATICMODE_H_
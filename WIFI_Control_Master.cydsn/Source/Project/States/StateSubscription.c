@@ -0,0 +1,88 @@
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       StateSubscription.c
+\brief      The subscription masks of the USER_STATE_SUBSCRIPTION_LIST are
+            generated at compile time. The main task checks the mask of the
+            current state before an event is passed to the state manager. Thus
+            the state handlers aren't called for events they would only return
+            as not processed.
+
+***********************************************************************************/
+
+/********************************* includes **********************************/
+#include "StateSubscription.h"
+#include "StateList.h"
+
+/***************************** defines / macros ******************************/
+#define SUBSCRIPTION_EVENT_IDS      32      //Event IDs which fit into the mask. Higher IDs are always passed
+
+#define EVT_OR_MASK(EventId)        | EVT_MASK(EventId)
+#define EVT_CHECK_ID(EventId)       _Static_assert((EventId) < SUBSCRIPTION_EVENT_IDS, "Subscribed event doesn't fit into the mask");
+
+/* Each subscribed event needs its own bit. A higher ID would shift out of the mask */
+#define SUBSCRIBE(StateName, EventList) EventList(EVT_CHECK_ID)
+    USER_STATE_SUBSCRIPTION_LIST
+    USER_STATE_SUBSCRIPTION_ALWAYS(EVT_CHECK_ID)
+#undef SUBSCRIBE
+
+/************************ local data type definitions ************************/
+
+/************************* local function prototypes *************************/
+
+/************************* local data (const and var) ************************/
+static const u32 ulSubscriptionMask[eSM_State_Max] =
+{
+    #define SUBSCRIBE(StateName, EventList) [StateName] = (0ul EventList(EVT_OR_MASK)),
+        USER_STATE_SUBSCRIPTION_LIST
+    #undef SUBSCRIBE
+};
+
+static const u32 ulAlwaysMask = (0ul USER_STATE_SUBSCRIPTION_ALWAYS(EVT_OR_MASK));
+
+/* Not a user state until the first entry function was called */
+static teSM_State eCurrentState = eSM_State_Max;
+
+/************************ export data (const and var) ************************/
+
+/****************************** local functions ******************************/
+
+/************************ externally visible functions ***********************/
+//***************************************************************************
+/*!
+\author     KraemerE
+\date       18.10.2026
+\brief      Sets the state whose mask shall be used. Has to be called in the
+            entry function of the state. The exit function resets it with
+            eSM_State_Max, so all events are passed while a transition is
+            pending.
+\return     none
+\param      eState - The state which was entered
+******************************************************************************/
+void StateSubscription_SetCurrentState(teSM_State eState)
+{
+    eCurrentState = eState;
+}
+
+
+//***************************************************************************
+/*!
+\author     KraemerE
+\date       18.10.2026
+\brief      Checks if the current state has subscribed the event.
+\return     bool - True when the event shall be passed to the state manager
+\param      eEventID - The event which shall be dispatched
+******************************************************************************/
+bool StateSubscription_IsSubscribed(teEventID eEventID)
+{
+    if(eCurrentState >= eSM_State_Max || (u32)eEventID >= SUBSCRIPTION_EVENT_IDS)
+    {
+        return true;
+    }
+
+    const u32 ulMask = ulSubscriptionMask[eCurrentState] | ulAlwaysMask;
+
+    return (ulMask & EVT_MASK(eEventID)) != 0;
+}
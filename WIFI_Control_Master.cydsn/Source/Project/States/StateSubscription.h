@@ -0,0 +1,36 @@
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+
+\file       StateSubscription.h
+\brief      Event subscription masks of the user states
+
+***********************************************************************************/
+#ifndef _STATE_SUBSCRIPTION_H_
+#define _STATE_SUBSCRIPTION_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/********************************* includes **********************************/
+#include "BaseTypes.h"
+#include "OS_EventManager.h"
+#include "OS_StateManager.h"
+
+/***************************** defines / macros ******************************/
+
+/************************ externally visible functions ***********************/
+void StateSubscription_SetCurrentState(teSM_State eState);
+bool StateSubscription_IsSubscribed(teEventID eEventID);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _STATE_SUBSCRIPTION_H_
+
+/* [] END OF FILE */
@@ -24,6 +24,11 @@
 #include "Aom_Time.h"
 
 #include "AutomaticMode.h"
+#include "PeriodicTask.h"
+#include "StateSubscription.h"
+#include "Profiler.h"
+#include "FaultLog.h"
+#include "EventQueue.h"
 
 
 /***************************** defines / macros ******************************/
@@ -32,6 +37,12 @@
 /************************ local data type definitions ************************/
 
 /************************* local function prototypes *************************/
+static void Active_Task2ms(void);
+static void Active_Task10ms(void);
+static void Active_Task51ms(void);
+static void Active_Task251ms(void);
+static void Active_Task1001ms(void);
+static void EvaluateAutomaticMode(void);
 
 /************************* local data (const and var) ************************/
 static u8 ucActiveOutputs = 0;
@@ -43,6 +54,16 @@ static u8 ucSW_Timer_FlashWrite = INVALID_TIMER_INDEX;
 static u8 ucSW_Timer_EnterStandby = INVALID_TIMER_INDEX;
 static u8 ucSW_Timer_EspReset = INVALID_TIMER_INDEX;
 
+/* Periodic tasks of this state in the order of the USER_PERIODIC_TASK_LIST */
+static const pFunctionPeriodicTask pfnActiveTasks[ePeriod_Max] =
+{
+    Active_Task2ms,
+    Active_Task10ms,
+    Active_Task51ms,
+    Active_Task251ms,
+    Active_Task1001ms
+};
+
 /************************ export data (const and var) ************************/
 
 
@@ -51,14 +72,15 @@ static u8 ucSW_Timer_EspReset = INVALID_TIMER_INDEX;
 /*!
 \author     KraemerE
 \date       04.05.2021
-\brief      Timeout callback for async timer. Saves the current user settings
-            into the flash.
+\brief      Timeout callback for async timer. The user settings are saved by
+            the root state, because the flash write shares its state with the
+            write done handling of the main loop.
 \return     none
 \param      none
 ******************************************************************************/
 void TimeoutFlashUserSettings(void)
 {
-    Aom_Flash_WriteUserSettingsInFlash();
+    EventQueue_PostToOs(eEvtNewRegulationValue, eEvtParam_SaveUserSettings, 0);
 }
 
 
@@ -72,7 +94,7 @@ void TimeoutFlashUserSettings(void)
 ******************************************************************************/
 void RequestStandbyState(void)
 {
-    OS_EVT_PostEvent(eEvtState_Request, eSM_State_Standby, 0);
+    EventQueue_PostToOs(eEvtState_Request, eSM_State_Standby, 0);
 }
 
 
@@ -121,6 +143,26 @@ static void SetNewRegulationValue(teEventParam eEvtParam, ulEventParam2 ulParam2
     int OutputIdx = 0;
     int OutputIdxEnd = DRIVE_OUTPUTS;
     
+    //The save timeout has elapsed
+    if(eEvtParam == eEvtParam_SaveUserSettings)
+    {
+        Aom_Flash_WriteUserSettingsInFlash();
+        return;
+    }
+    
+    //A scene changes all outputs at once. The second parameter is the fade time.
+    if(eEvtParam == eEvtParam_SceneRecall)
+    {
+        for(; OutputIdx < OutputIdxEnd; OutputIdx++)
+        {
+            const tLedValue* psLedVal = Aom_GetOutputsSettingsEntry(OutputIdx);
+            DR_Regulation_ChangeState(psLedVal->bStatus == ON ? eStateActiveR : eStateOff, (u8)OutputIdx);
+        }
+        
+        DR_Regulation_StartFade((u16)ulParam2);
+        return;
+    }
+    
     //Check if not all outputs shall be used.
     if(ulParam2 != DRIVE_OUTPUTS)
     {
@@ -134,8 +176,15 @@ static void SetNewRegulationValue(teEventParam eEvtParam, ulEventParam2 ulParam2
         {
             case eEvtParam_RegulationValueStartTimer:
             {
-                /* Restart the flash timeout */
-                OS_SW_Timer_SetTimerState(ucSW_Timer_FlashWrite, eSwTimer_StatusRunning);
+                /* Restart the flash timeout unless the changes were written because of the maximum deferral */
+                if(Aom_Flash_UserSettingsChanged())
+                {
+                    OS_SW_Timer_SetTimerState(ucSW_Timer_FlashWrite, eSwTimer_StatusSuspended);
+                }
+                else
+                {
+                    OS_SW_Timer_SetTimerState(ucSW_Timer_FlashWrite, eSwTimer_StatusRunning);
+                }
                 break;
             }
             
@@ -182,6 +231,146 @@ static void SetNewRegulationValue(teEventParam eEvtParam, ulEventParam2 ulParam2
     
 }
 
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      2ms-Tick. Measurement and regulation of the outputs.
+\param      none
+\return     none
+***********************************************************************************/
+static void Active_Task2ms(void)
+{
+    PROFILE_START(eProfile_MeasureTick);
+    DR_Measure_Tick();
+    PROFILE_STOP(eProfile_MeasureTick);
+    
+    PROFILE_START(eProfile_RegulationHandler);
+    ucActiveOutputs = DR_Regulation_Handler(SW_TIMER_2MS);
+    PROFILE_STOP(eProfile_RegulationHandler);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      10ms-Tick. Starts or stops the standby timeout.
+\param      none
+\return     none
+***********************************************************************************/
+static void Active_Task10ms(void)
+{
+    /* Get standby-timer state */
+    teSW_TimerStatus eTimerState = OS_SW_Timer_GetTimerState(ucSW_Timer_EnterStandby);
+    
+    /* Start the timeout for the standby when all regulation states are off */
+    if(ucActiveOutputs == 0)
+    {
+        if(eTimerState == eSwTimer_StatusSuspended && Aom_System_StandbyAllowed())
+        {
+            /* Start the timeout for the standby timeout */
+            OS_SW_Timer_SetTimerState(ucSW_Timer_EnterStandby, eSwTimer_StatusRunning);
+        }
+    }
+    else if(eTimerState == eSwTimer_StatusRunning)
+    {
+        /* Stop standby timeout when its counting */
+        OS_SW_Timer_SetTimerState(ucSW_Timer_EnterStandby, eSwTimer_StatusSuspended);
+    }
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      51ms-Tick. Fault detection and message retries.
+\param      none
+\return     none
+***********************************************************************************/
+static void Active_Task51ms(void)
+{
+    /* Check for over-current faults */
+    DR_ErrorDetection_CheckCurrentValue();
+    
+    /* Check for over-temperature faults */
+    DR_ErrorDetection_CheckAmbientTemperature();
+    
+    /* Handle message in the retry buffer */
+    PROFILE_START(eProfile_MessageHandlerTick);
+    MessageHandler_Tick(SW_TIMER_51MS);
+    PROFILE_STOP(eProfile_MessageHandlerTick);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Evaluates the automatic mode. Returns directly when none of its
+            inputs has changed.
+\param      none
+\return     none
+***********************************************************************************/
+static void EvaluateAutomaticMode(void)
+{
+    PROFILE_START(eProfile_AutomaticModeHandler);
+    AutomaticMode_Handler();
+    PROFILE_STOP(eProfile_AutomaticModeHandler);
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      251ms-Tick. Motions are detected by the PIR interrupt. Only the
+            edges which were ignored within the debounce time are taken over.
+\param      none
+\return     none
+***********************************************************************************/
+static void Active_Task251ms(void)
+{
+    DR_UI_MotionDebounceTick();
+}
+
+
+//********************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      1001ms-Tick. LEDs, measured values and the output state message.
+\param      none
+\return     none
+***********************************************************************************/
+static void Active_Task1001ms(void)
+{
+    AutomaticMode_Tick(SW_TIMER_1001MS);
+    
+    /* Switch off when the burning time has expired */
+    EvaluateAutomaticMode();
+    
+    /* Write the logged faults when they have waited long enough */
+    FaultLog_Tick();
+                    
+    /* Toggle LED to show a living CPU */
+    DR_UI_ToggleHeartBeatLED();
+    
+    /* Toggle error LED when an error is in timeout */
+    DR_UI_ToggleErrorLED();
+
+    /* Calculate voltage, current and temperature and send them afterwards to the slave */
+    Aom_Measure_SetMeasuredValues(true, true, true);
+    
+    /* Check first if the slave is active before sending a request */
+    if(Aom_System_GetSystemStarted())
+    {
+        MessageHandler_SendOutputState();
+    }
+}
+
 /************************ externally visible functions ***********************/
 //***************************************************************************
 /*!
@@ -202,6 +391,9 @@ u8 State_Active_Entry(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2
     (void)uiParam1;
     (void)ulParam2;
     
+    /* Dispatch only the subscribed events to this state */
+    StateSubscription_SetCurrentState(eSM_State_Active);
+    
     switch(eEventID)
     {
         default:
@@ -233,6 +425,20 @@ u8 State_Active_Entry(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2
         bModulesInit = true;
     }
     
+    /* Stop the wake-up latency measurement */
+    DR_Regulation_WakeLatencyActiveReached();
+    
+    /* The timer ticks are handled by the periodic tasks of this state */
+    PeriodicTask_Register(pfnActiveTasks);
+    
+    /* Post the light state of the automatic mode once after the entry */
+    AutomaticMode_RequestEvaluation(true);
+    
+    /* Motions are detected with both edges of the PIR pin. Edges which weren't
+       taken before the transition are notified again */
+    DR_UI_EnableMotionInterrupt();
+    DR_UI_ResumeMotionEdges();
+    
     /* Switch on system */    
     //const tRegulationValues* psRegVal = Aom_Regulation_GetRegulationValuesPointer();
     //u8 ucOutputIdx;
@@ -264,80 +470,6 @@ u8 State_Active_Root(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2 u
     
     switch(eEventID)
     {
-        case eEvtSoftwareTimer:
-        {
-            /******* 2ms-Tick **********/
-            if(ulParam2 == EVT_SW_TIMER_2MS)
-            {
-                DR_Measure_Tick();
-                ucActiveOutputs = DR_Regulation_Handler(SW_TIMER_2MS);
-            }
-            
-            /******* 10ms-Tick **********/
-            else if(ulParam2 == EVT_SW_TIMER_10MS)
-            {
-                /* Get standby-timer state */
-                teSW_TimerStatus eTimerState = OS_SW_Timer_GetTimerState(ucSW_Timer_EnterStandby);
-                
-                /* Start the timeout for the standby when all regulation states are off */
-                if(ucActiveOutputs == 0)
-                {
-                    if(eTimerState == eSwTimer_StatusSuspended && Aom_System_StandbyAllowed())
-                    {
-                        /* Start the timeout for the standby timeout */
-                        OS_SW_Timer_SetTimerState(ucSW_Timer_EnterStandby, eSwTimer_StatusRunning);
-                    }
-                }
-                else if(eTimerState == eSwTimer_StatusRunning)
-                {
-                    /* Stop standby timeout when its counting */
-                    OS_SW_Timer_SetTimerState(ucSW_Timer_EnterStandby, eSwTimer_StatusSuspended);
-                }
-            }
-            
-            /******* 51ms-Tick **********/
-            else if(ulParam2 == EVT_SW_TIMER_51MS)
-            {
-                /* Check for over-current faults */
-                DR_ErrorDetection_CheckCurrentValue();
-                
-                /* Check for over-temperature faults */
-                DR_ErrorDetection_CheckAmbientTemperature();
-                
-                /* Handle message in the retry buffer */
-                MessageHandler_Tick(SW_TIMER_51MS);
-            }
-            
-            /******* 251ms-Tick **********/
-            else if(ulParam2 == EVT_SW_TIMER_251MS)
-            {
-                DR_UI_CheckSensorForMotion();
-                AutomaticMode_Handler();
-            }
-            
-            /******* 1001ms-Tick **********/
-            else if(ulParam2 == EVT_SW_TIMER_1001MS)
-            {                        
-                AutomaticMode_Tick(SW_TIMER_1001MS);
-                                
-                /* Toggle LED to show a living CPU */
-                DR_UI_ToggleHeartBeatLED();
-                
-                /* Toggle error LED when an error is in timeout */
-                DR_UI_ToggleErrorLED();
-
-                /* Calculate voltage, current and temperature and send them afterwards to the slave */
-                Aom_Measure_SetMeasuredValues(true, true, true);
-                
-                /* Check first if the slave is active before sending a request */
-                if(Aom_System_GetSystemStarted())
-                {
-                    MessageHandler_SendOutputState();
-                }
-            }            
-            break;
-        }//eEvtSoftwareTimer
-        
         case eEvtNewRegulationValue:
         {
             SetNewRegulationValue(uiParam1, ulParam2);
@@ -364,6 +496,7 @@ u8 State_Active_Root(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2 u
             
             /* Check for handling in automatic mode */
             AutomaticMode_TimeUpdated();
+            EvaluateAutomaticMode();
             break;
         }
                 
@@ -390,9 +523,22 @@ u8 State_Active_Root(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2 u
         }
         
         
-        case eEvtAutomaticMode_ResetBurningTimeout:
+        case eEvtAutomaticMode_MotionEdge:
+        {
+            /* The burning time starts again with the start and the end of a motion */
+            if(DR_UI_TakeMotionEdges())
+            {
+                AutomaticMode_ResetBurningTimeout();
+            }
+            
+            /* React on the edge without waiting for a periodic task */
+            EvaluateAutomaticMode();
+            break;
+        }
+        
+        case eEvtFlashWriteDone:
         {
-            AutomaticMode_ResetBurningTimeout();
+            Aom_Flash_WriteDone((teFlashJob)ulParam2, uiParam1);
             break;
         }
         
@@ -427,6 +573,12 @@ u8 State_Active_Exit(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2 u
     (void)uiParam1;
     (void)ulParam2;
     
+    /* Pass all events until the next state is entered */
+    StateSubscription_SetCurrentState(eSM_State_Max);
+    
+    /* Stop the periodic tasks of this state */
+    PeriodicTask_Unregister();
+    
     /* Delete software timer which are related to this state */ 
     if(OS_SW_Timer_GetTimerState(ucSW_Timer_2ms) != eSwTimer_StatusInvalid)
         OS_SW_Timer_DeleteTimer(&ucSW_Timer_2ms);
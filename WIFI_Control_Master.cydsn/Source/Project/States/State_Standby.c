@@ -14,6 +14,7 @@
 #include "DR_ErrorDetection.h"
 #include "DR_Measure.h"
 #include "DR_Regulation.h"
+#include "DR_UserInterface.h"
 
 #include "MessageHandler.h"
 
@@ -25,14 +26,18 @@
 
 #include "AutomaticMode.h"
 #include "State_Standby.h"
+#include "StateSubscription.h"
+#include "DR_Flash.h"
+#include "FaultLog.h"
+#include "EventQueue.h"
 
 /***************************** defines / macros ******************************/
-#define NIGHT_MODE_START        22
-#define NIGHT_MODE_STOP         5
-
 #define STDBY_MSG_TIMEOUT      3000   //3 sec for reset timeout
 #define RESET_CTRL_TIMEOUT     3000     // 3 sec timeout for ESP reset
 
+#define TRANSITION_UNKNOWN      0            // Next transition has to be calculated
+#define TRANSITION_NONE         0xFFFFFFFF   // No transition in the schedule
+
 /************************ local data type definitions ************************/
 
 /************************* local function prototypes *************************/
@@ -41,6 +46,9 @@
 static bool bStandbyAllowed = true;
 static bool bSlaveReseted = false;
 
+/* RTC time of the next schedule transition */
+static u32 ulNextTransitionTicks = TRANSITION_UNKNOWN;
+
 static u8 ucSW_Timer_MsgRxTimeout = INVALID_TIMER_INDEX;
 static u8 ucSW_Timer_EspResetTimeout = INVALID_TIMER_INDEX;
 /************************ export data (const and var) ************************/
@@ -79,6 +87,69 @@ static void ResetSlaveByTimeout(void)
     bSlaveReseted = true;
 }
 
+//***************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Saves the RTC time of the next on/off transition of the automatic
+            mode. The transition is on a full minute.
+\return     none
+\param      none
+******************************************************************************/
+static void ScheduleNextTransition(void)
+{
+    const tsCurrentTime* psTime = Aom_Time_GetCurrentTime();
+    
+    /* The time wasn't received yet */
+    if(psTime->ulTicks == 0)
+    {
+        ulNextTransitionTicks = TRANSITION_NONE;
+        return;
+    }
+    
+    const u16 uiMinutes = AutomaticMode_GetMinutesToNextTransition();
+    
+    if(uiMinutes)
+    {
+        ulNextTransitionTicks = psTime->ulTicks - (psTime->ulTicks % 60) + ((u32)uiMinutes * 60);
+    }
+    else
+    {
+        ulNextTransitionTicks = TRANSITION_NONE;
+    }
+}
+
+//***************************************************************************
+/*!
+\author     Kraemer E.
+\date       18.10.2026
+\brief      Updates the automatic mode when the next transition is reached.
+            The RTC time of any other update is only compared, the CPU returns
+            to deep sleep without waking up the ESP. Leaves the standby state
+            when the time slot switches on the light.
+\return     none
+\param      none
+******************************************************************************/
+static void CheckScheduleTransition(void)
+{
+    const tsCurrentTime* psTime = Aom_Time_GetCurrentTime();
+    
+    if(ulNextTransitionTicks != TRANSITION_UNKNOWN && psTime->ulTicks < ulNextTransitionTicks)
+    {
+        return;
+    }
+    
+    AutomaticMode_TimeUpdated();
+    
+    if(AutomaticMode_LightOnBySchedule())
+    {
+        bStandbyAllowed = false;
+        EventQueue_PostToOs(eEvtState_Request, eSM_State_Active, 0);
+    }
+    
+    ScheduleNextTransition();
+}
+
 //********************************************************************************
 /*!
 \author  KraemerE
@@ -90,9 +161,15 @@ static void ResetSlaveByTimeout(void)
 ***********************************************************************************/
 static void EnterSleepMode(void)
 {    
-    /* Check if transmision is done */
-    if(OS_Serial_UART_TransmitStatus() == true)
+    /* The flush delay of the fault log doesn't run in the deep sleep. Write the faults of the standby before */
+    FaultLog_Flush();
+    
+    /* Check if transmision is done and no flash write is running */
+    if(OS_Serial_UART_TransmitStatus() == true && DR_Flash_IsBusy() == false)
     {
+        /* The tick counter stops in the deep sleep. A motion wakes up without debounce time */
+        DR_UI_RearmMotionDebounce();
+        
         /* Enable wake-up sources before critical section is entered */
         DR_Regulation_SetWakeupInterrupts();
         
@@ -117,6 +194,9 @@ static void EnterSleepMode(void)
         /* Enter critical section */
         LeaveCritical(ucInterruptStatus);
         
+        /* The PIR interrupt was served with the critical section. Light up before the event loop continues */
+        DR_Regulation_FastWakeOutputs();
+        
         /* Disable wake-up sources after critical section is left */
         DR_Regulation_DeleteWakeupInterrupts();        
     }
@@ -142,6 +222,9 @@ u8 State_Standby_Entry(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2
     (void)uiParam1;
     (void)ulParam2;
     
+    /* Dispatch only the subscribed events to this state */
+    StateSubscription_SetCurrentState(eSM_State_Standby);
+    
     switch(eEventID)
     {
         default:
@@ -149,6 +232,16 @@ u8 State_Standby_Entry(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2
             break;
     }
     
+    /* Write the changed user settings and the logged faults before the sleep */
+    Aom_Flash_FlushUserSettings();
+    FaultLog_Flush();
+    
+    /* Notify the PIR edges again which weren't taken before the transition */
+    DR_UI_ResumeMotionEdges();
+    
+    /* Calculate when the automatic mode has to switch the next time */
+    ScheduleNextTransition();
+    
     /* Send sleep message */
     MessageHandler_SendSleepOrWakeUpMessage(true);
     bSlaveReseted = false;
@@ -196,16 +289,19 @@ u8 State_Standby_Root(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2
             break;
         }
                                         
-        case eEvtAutomaticMode_ResetBurningTimeout:
+        case eEvtAutomaticMode_MotionEdge:
         {
             /* Motion sensor has detected motion */
-            AutomaticMode_ResetBurningTimeout();
-            
-            /* Check if standby mode can be left */
-            if(AutomaticMode_LeaveStandbyMode())
+            if(DR_UI_TakeMotionEdges())
             {
-                bStandbyAllowed = false;
-                OS_EVT_PostEvent(eEvtState_Request, eSM_State_Active, 0);
+                AutomaticMode_ResetBurningTimeout();
+                
+                /* Check if standby mode can be left */
+                if(AutomaticMode_LeaveStandbyMode())
+                {
+                    bStandbyAllowed = false;
+                    EventQueue_PostToOs(eEvtState_Request, eSM_State_Active, 0);
+                }
             }
             break;
         }
@@ -215,12 +311,74 @@ u8 State_Standby_Root(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2
             /* Send a wake-up-message */
             MessageHandler_SendSleepOrWakeUpMessage(false);
             bStandbyAllowed = false;
-            OS_EVT_PostEvent(eEvtState_Request, eSM_State_Active, 0);
+            EventQueue_PostToOs(eEvtState_Request, eSM_State_Active, 0);
+            break;
+        }
+        
+        case eEvtFlashWriteDone:
+        {
+            Aom_Flash_WriteDone((teFlashJob)ulParam2, uiParam1);
             break;
         }
         
-        case eEvtNewRegulationValue:
         case eEvtTimeReceived:
+        {
+            if(uiParam1 == eEvtParam_TimeFromNtpClient)
+            {
+                /* Time is new and the ESP is awake. Update the RTC and send sleep message again */
+                OS_RealTimeClock_SetTime(Aom_Time_GetCurrentTime()->ulTicks);
+                MessageHandler_SendSleepOrWakeUpMessage(true);
+                ulNextTransitionTicks = TRANSITION_UNKNOWN;
+            }
+            
+            CheckScheduleTransition();
+            break;
+        }
+        
+        case eEvtNewRegulationValue:
+        {
+            /* There is no save timeout in standby. Write the changed user settings before the next sleep */
+            if(uiParam1 == eEvtParam_RegulationValueStartTimer)
+            {
+                Aom_Flash_UserSettingsChanged();
+                Aom_Flash_FlushUserSettings();
+            }
+            else if(uiParam1 == eEvtParam_SaveUserSettings)
+            {
+                /* Save timeout of the active state which elapsed during the transition */
+                Aom_Flash_FlushUserSettings();
+            }
+            else if(uiParam1 == eEvtParam_SceneRecall)
+            {
+                /* A scene which switches on an output wakes up. The active state fades to the scene */
+                bool bOutputOn = false;
+                
+                u8 ucOutputIdx;
+                for(ucOutputIdx = 0; ucOutputIdx < DRIVE_OUTPUTS; ucOutputIdx++)
+                {
+                    if(Aom_GetOutputsSettingsEntry(ucOutputIdx)->bStatus == ON)
+                    {
+                        bOutputOn = true;
+                    }
+                }
+                
+                if(bOutputOn)
+                {
+                    bStandbyAllowed = false;
+                    EventQueue_PostToOs(eEvtState_Request, eSM_State_Active, 0);
+                    EventQueue_PostToOs(eEvtNewRegulationValue, eEvtParam_SceneRecall, ulParam2);
+                }
+            }
+            
+            /* Settings could have changed the time slots */
+            ulNextTransitionTicks = TRANSITION_UNKNOWN;
+            CheckScheduleTransition();
+            
+            /* Send sleep message */
+            MessageHandler_SendSleepOrWakeUpMessage(true);
+            break;
+        }
+        
         case eEvtSerialMsgReceived:
         {
             /* Send sleep message */
@@ -267,6 +425,9 @@ u8 State_Standby_Exit(teEventID eEventID, uiEventParam1 uiParam1, ulEventParam2
     (void)uiParam1;
     (void)ulParam2;
     
+    /* Pass all events until the next state is entered */
+    StateSubscription_SetCurrentState(eSM_State_Max);
+    
     /* Enable measurement module */
     DR_Measure_Start();
         
@@ -20,11 +20,21 @@
 
 #include "HAL_Timer.h"
 
+#include "DR_System.h"
+#include "EventQueue.h"
+#include "FlightRecorder.h"
+#include "PeriodicTask.h"
+#include "StateSubscription.h"
+#include "SelfTestScheduler.h"
+#include "DR_Flash.h"
+#include "FaultLog.h"
+#include "TimerTable.h"
+#include "Scene.h"
+#include "Occupancy.h"
+
 #define LOG_NOT_PROCESSED_EVTS  true
 
 static tsEventMsg sEvt = {eEvtNone, eEvtParam_None, eEvtParam_None};
-static tsEventMsg sNotProcessedEvents[10];
-static u8 ucNotProcessedEvtIndex = 0;
 
 void CyBoot_Start_c_Callback(void)
 {
@@ -38,56 +48,128 @@ static void ClearEventStruct(tsEventMsg* psEvt)
     psEvt->param2 = eEvtParam_None;
 }
 
-static void Main_Task(void)
-{   
+/* Programs the next flash row or runs the next self-test step when the
+ * scheduler allows it. When nothing was done and no event is pending the
+ * CPU sleeps until the next interrupt.
+ */
+static void Main_Idle(bool bEventsPending)
+{
+    /* At most one flash row per iteration and only when no event waits */
+    if(bEventsPending == false && DR_Flash_Process())
+    {
+        return;
+    }
+
+    if(SelfTestScheduler_Run(bEventsPending) == false && bEventsPending == false)
+    {
+        const u8 ucCriticalSection = EnterCritical();
+
+        /* An interrupt could have posted an event since the last check */
+        if(EventQueue_Ingest() == 0)
+        {
+            DR_System_EnterIdleSleep();
+        }
+
+        LeaveCritical(ucCriticalSection);
+    }
+}
+
+/* Gets the next event when the last one was handled and passes it to the
+ * main state and the state machine.
+ * Returns false when no event is pending.
+ */
+static bool Main_DispatchEvent(void)
+{
     /* Check if event was handled */
     if(sEvt.eEventID == eEvtNone)
     {
-        /* Get new event */
-        OS_EVT_GetEvent(&sEvt);
+        /* Take over the posted events and get the one with the highest priority */
+        EventQueue_Ingest();
+        EventQueue_GetEvent(&sEvt);
     }
 
     /* Check if new or old event is available */
-    if(sEvt.eEventID != eEvtNone)
+    if(sEvt.eEventID == eEvtNone)
     {
-        /* Call main state first. Afterwards the events can be used by
-         * the other states. */
-        u8 ucMainStateProcessed = OS_State_Main(sEvt.eEventID, sEvt.param1, sEvt.param2);
-        u8 ucStateProcessed = OS_StateManager_Handle(sEvt.eEventID, sEvt.param1, sEvt.param2);
+        return false;
+    }
 
-        /* Use state machine handler */
-        if(ucMainStateProcessed == EVT_PROCESSED || ucStateProcessed == EVT_PROCESSED)
-        {
-            ClearEventStruct(&sEvt);
-        }
-        else
-        {
-            #if LOG_NOT_PROCESSED_EVTS
-                if(ucNotProcessedEvtIndex < 10)
-                {
-                    ucNotProcessedEvtIndex++;
-                }
-                else
-                {
-                    ucNotProcessedEvtIndex = 0;
-                }
-                
-                memcpy(&sNotProcessedEvents[ucNotProcessedEvtIndex], &sEvt, sizeof(tsEventMsg));
-                
-                ClearEventStruct(&sEvt);
-            #else
-                /* Event has not been processed from main-state nor from other states */
-                OS_ErrorDebouncer_PutErrorInQueue(eEventError_NotProcessed);
-            #endif
-        }
+    const u32 ulExecStart = DR_System_GetCycleCount();
 
+    /* Timer ticks are passed directly to the periodic tasks of the current state */
+    if(sEvt.eEventID == eEvtSoftwareTimer && PeriodicTask_Dispatch(sEvt.param2))
+    {
+        EventQueue_RecordExecution(sEvt.eEventID, DR_System_CyclesToUs(DR_System_GetCycleCount() - ulExecStart));
+        ClearEventStruct(&sEvt);
+        return true;
+    }
+
+    /* Log the event before it is handled. A stall in a handler is visible after the watchdog reset */
+    if(sEvt.eEventID == eEvtState_Request)
+    {
+        FlightRecorder_Record(eFlightRec_StateRequest, (u8)sEvt.eEventID, sEvt.param1, sEvt.param2);
     }
     else
     {
-        /* Currently no event. use Self-test routine */
-        OS_SelfTest_Cyclic_Run();
+        FlightRecorder_Record(eFlightRec_Event, (u8)sEvt.eEventID, sEvt.param1, sEvt.param2);
     }
 
+    /* Call main state first. Afterwards the events can be used by
+     * the other states. */
+    u8 ucMainStateProcessed = OS_State_Main(sEvt.eEventID, sEvt.param1, sEvt.param2);
+    u8 ucStateProcessed = EVT_NOT_PROCESSED;
+
+    /* The current state is skipped when it hasn't subscribed the event */
+    if(StateSubscription_IsSubscribed(sEvt.eEventID))
+    {
+        ucStateProcessed = OS_StateManager_Handle(sEvt.eEventID, sEvt.param1, sEvt.param2);
+    }
+
+    EventQueue_RecordExecution(sEvt.eEventID, DR_System_CyclesToUs(DR_System_GetCycleCount() - ulExecStart));
+
+    /* Use state machine handler */
+    if(ucMainStateProcessed == EVT_PROCESSED || ucStateProcessed == EVT_PROCESSED)
+    {
+        ClearEventStruct(&sEvt);
+    }
+    else
+    {
+        #if LOG_NOT_PROCESSED_EVTS
+            FlightRecorder_Record(eFlightRec_NotProcessed, (u8)sEvt.eEventID, sEvt.param1, sEvt.param2);
+            
+            ClearEventStruct(&sEvt);
+        #else
+            /* Event has not been processed from main-state nor from other states */
+            OS_ErrorDebouncer_PutErrorInQueue(eEventError_NotProcessed);
+        #endif
+    }
+
+    return true;
+}
+
+static void Main_Task(void)
+{   
+    const u32 ulBatchStartTick = DR_System_GetTickMs();
+    u8 ucBatchCnt = 0;
+    bool bEventsPending = false;
+
+    /* Handle the events in a batch until the count or time budget is used up */
+    while(Main_DispatchEvent())
+    {
+        /* Clear watchdog counter */
+        OS_WDT_ClearWatchdogCounter();
+
+        if(++ucBatchCnt >= EVT_BATCH_MAX_EVENTS
+            || (DR_System_GetTickMs() - ulBatchStartTick) >= EVT_BATCH_MAX_TIME_MS)
+        {
+            bEventsPending = true;
+            break;
+        }
+    }
+
+    /* Batch done. Use self-test routine or sleep */
+    Main_Idle(bEventsPending);
+
     /* Clear watchdog counter */
     OS_WDT_ClearWatchdogCounter();
 }
@@ -102,6 +184,30 @@ int main(void)
 
     /* Initialize state manager */
     OS_StateManager_Init();
+
+    /* Start the millisecond time base */
+    DR_System_Init();
+    
+    /* Initialize the prioritized event queue */
+    EventQueue_Init();
+    
+    /* Start the first coverage cycle of the self-tests */
+    SelfTestScheduler_Init();
+    
+    /* Keep the log of the previous boot and start a new one */
+    FlightRecorder_Init();
+    
+    /* Continue the fault log behind the newest entry */
+    FaultLog_Init();
+    
+    /* Load and compile the timer table */
+    TimerTable_Init();
+    
+    /* Load the scene presets */
+    Scene_Init();
+    
+    /* Load the learned motion gaps */
+    Occupancy_Init();
     
     /* Initialize the Watchdog with 2 second intervall */
     OS_WDT_InitWatchdog(2000);